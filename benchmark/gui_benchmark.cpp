@@ -0,0 +1,266 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+// Renders the main page of the given assets file with the headless simulator
+// display and prints per frame and per widget type render times.
+//
+// usage: eez-gui-benchmark <assets file> [number of frames] [--animations]
+//
+// With --animations page transitions (slide and open/close) are started one
+// after another and animation frame times are reported separately. Display size
+// comes from the project configuration, e.g. build it with 800x480 and 1280x800.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <atomic>
+
+#include <eez/conf-internal.h>
+
+#include <eez/core/os.h>
+#include <eez/core/assets.h>
+#include <eez/core/memory.h>
+
+#include <eez/gui/gui.h>
+#include <eez/gui/thread.h>
+#include <eez/gui/display.h>
+#include <eez/gui/render_stats.h>
+
+#include <eez/flow/flow.h>
+
+#if !EEZ_OPTION_HEADLESS_DISPLAY || !EEZ_OPTION_GUI_RENDER_STATS
+#error "benchmark requires EEZ_OPTION_HEADLESS_DISPLAY and EEZ_OPTION_GUI_RENDER_STATS"
+#endif
+
+namespace eez {
+bool g_shutdown;
+}
+
+using namespace eez;
+
+// first frames are spent in page creation and are not measured
+static const uint32_t NUM_WARMUP_FRAMES = 10;
+
+// inject touch down/up every TOUCH_PERIOD frames
+static const uint32_t TOUCH_PERIOD = 30;
+
+static void (*g_defaultStateManagment)();
+static uint32_t g_tickCounter;
+
+static uint32_t g_numFrames = 1000;
+
+// set by the GUI thread as the last thing it does before leaving its main loop,
+// after that render stats are no longer touched and can be read from main()
+static std::atomic<bool> g_done;
+
+static bool g_animations;
+static uint32_t g_animationCounter;
+
+static void nudgeGlobalVariables() {
+    if (!eez::g_mainAssets->flowDefinition) {
+        return;
+    }
+
+    auto numGlobalVariables = eez::g_mainAssets->flowDefinition->globalVariables.count;
+    for (uint32_t i = 0; i < numGlobalVariables; i++) {
+        auto value = flow::getGlobalVariable(i);
+        if (value.isInt32()) {
+            flow::setGlobalVariable(i, Value((int)(g_tickCounter % 100), VALUE_TYPE_INT32));
+        } else if (value.isFloat()) {
+            flow::setGlobalVariable(i, Value(50.0f + 50.0f * sinf(g_tickCounter * 0.1f), VALUE_TYPE_FLOAT));
+        } else if (value.isDouble()) {
+            flow::setGlobalVariable(i, Value(50.0 + 50.0 * sin(g_tickCounter * 0.1), VALUE_TYPE_DOUBLE));
+        }
+    }
+}
+
+static void injectTouch() {
+    auto phase = g_tickCounter % TOUCH_PERIOD;
+    if (phase != 0 && phase != 1) {
+        return;
+    }
+
+    // walk touch position over the display
+    auto n = g_tickCounter / TOUCH_PERIOD;
+
+    gui::Event event;
+    event.time = millis();
+    event.type = phase == 0 ? gui::EVENT_TYPE_TOUCH_DOWN : gui::EVENT_TYPE_TOUCH_UP;
+    event.x = (int)(n * 37 % gui::display::getDisplayWidth());
+    event.y = (int)(n * 53 % gui::display::getDisplayHeight());
+    gui::processTouchEvent(event);
+}
+
+#if EEZ_OPTION_GUI_ANIMATIONS
+static void startAnimation() {
+    if (gui::g_animationState.enabled) {
+        return;
+    }
+
+    auto appContext = gui::getAppContextFromId(APP_CONTEXT_ID_DEVICE);
+    int16_t w = (int16_t)appContext->rect.w;
+    int16_t h = (int16_t)appContext->rect.h;
+
+    if (g_animationCounter++ % 2 == 0) {
+        // slide new page in from the right, old page out to the left
+        gui::AnimRect &oldPage = gui::g_animRects[0];
+        oldPage.buffer = gui::BUFFER_OLD;
+        oldPage.srcRect = { 0, 0, w, h };
+        oldPage.dstRect = { (int16_t)-w, 0, w, h };
+        oldPage.opacity = gui::OPACITY_SOLID;
+        oldPage.position = gui::POSITION_TOP_LEFT;
+
+        gui::AnimRect &newPage = gui::g_animRects[1];
+        newPage.buffer = gui::BUFFER_NEW;
+        newPage.srcRect = { w, 0, w, h };
+        newPage.dstRect = { 0, 0, w, h };
+        newPage.opacity = gui::OPACITY_SOLID;
+        newPage.position = gui::POSITION_TOP_LEFT;
+
+        gui::animateRects(appContext, gui::BUFFER_OLD, 2);
+    } else {
+        // popup opened from the small rectangle in the center
+        gui::Rect srcRect = { (int16_t)(w / 2 - 20), (int16_t)(h / 2 - 10), 40, 20 };
+        gui::Rect dstRect = { (int16_t)(w / 8), (int16_t)(h / 8), (int16_t)(w * 3 / 4), (int16_t)(h * 3 / 4) };
+        gui::animateOpen(srcRect, dstRect);
+    }
+}
+#endif
+
+static void benchmarkStateManagment() {
+    if (!gui::display::isOn()) {
+        gui::display::turnOn();
+    }
+
+    g_defaultStateManagment();
+
+    if (gui::g_frameRenderStats.numFrames == NUM_WARMUP_FRAMES) {
+        gui::resetRenderStats();
+    }
+
+    nudgeGlobalVariables();
+
+    if (g_animations) {
+#if EEZ_OPTION_GUI_ANIMATIONS
+        startAnimation();
+#endif
+    } else {
+        injectTouch();
+    }
+
+    g_tickCounter++;
+
+    if (gui::g_frameRenderStats.numFrames >= g_numFrames && g_tickCounter > NUM_WARMUP_FRAMES) {
+        // stop from within the GUI thread, so no frame is rendered after this point
+        g_shutdown = true;
+        g_done.store(true, std::memory_order_release);
+    }
+}
+
+static bool loadAssetsFile(const char *filePath) {
+    FILE *fp = fopen(filePath, "rb");
+    if (!fp) {
+        printf("Can't open %s\n", filePath);
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    auto size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    auto data = (uint8_t *)malloc(size);
+    if (!data || fread(data, 1, size, fp) != (size_t)size) {
+        printf("Can't read %s\n", filePath);
+        fclose(fp);
+        ::free(data);
+        return false;
+    }
+    fclose(fp);
+
+    // assets data must stay alive, it can be referenced from the main assets
+    eez::loadMainAssets(data, (uint32_t)size);
+    return true;
+}
+
+static void printFrameStats(const char *title, const gui::FrameRenderStats &frameStats) {
+    printf("%s: %u\n", title, (unsigned)frameStats.numFrames);
+    if (frameStats.numFrames > 0) {
+        printf("    time [us]: avg %.1f, min %.1f, max %.1f\n",
+            frameStats.totalFrameTimeNs / 1000.0 / frameStats.numFrames,
+            frameStats.minFrameTimeNs / 1000.0,
+            frameStats.maxFrameTimeNs / 1000.0);
+    }
+}
+
+static void printStats() {
+    auto &frameStats = gui::g_frameRenderStats;
+    if (frameStats.numFrames == 0) {
+        printf("No frames rendered\n");
+        return;
+    }
+
+    printf("Display: %dx%d\n", gui::display::getDisplayWidth(), gui::display::getDisplayHeight());
+
+    printFrameStats("Frames", frameStats);
+    if (g_animations) {
+        printFrameStats("Animation frames", gui::g_animationFrameRenderStats);
+    }
+
+    printf("\n%-24s %10s %14s %12s %14s\n", "Widget type", "renders", "total [us]", "avg [us]", "pixels/frame");
+    for (int i = 0; i < gui::NUM_WIDGET_TYPES; i++) {
+        auto &stats = gui::g_widgetTypeRenderStats[i];
+        if (stats.numRenders == 0) {
+            continue;
+        }
+        printf("%-24s %10u %14.1f %12.2f %14.0f\n",
+            gui::getWidgetTypeName(i),
+            (unsigned)stats.numRenders,
+            stats.renderTimeNs / 1000.0,
+            stats.renderTimeNs / 1000.0 / stats.numRenders,
+            (double)stats.numPixels / frameStats.numFrames);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s <assets file> [number of frames] [--animations]\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--animations") == 0) {
+            g_animations = true;
+        } else {
+            g_numFrames = (uint32_t)atoi(argv[i]);
+        }
+    }
+
+    eez::initMemory();
+
+    if (!loadAssetsFile(argv[1])) {
+        return 1;
+    }
+
+    g_defaultStateManagment = gui::g_hooks.stateManagment;
+    gui::g_hooks.stateManagment = benchmarkStateManagment;
+
+    gui::startThread();
+
+    while (!g_done.load(std::memory_order_acquire)) {
+        osDelay(100);
+    }
+
+    printStats();
+
+    return 0;
+}
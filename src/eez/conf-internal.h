@@ -58,9 +58,39 @@
         #ifndef EEZ_OPTION_GUI_ANIMATIONS
             #define EEZ_OPTION_GUI_ANIMATIONS 1
         #endif
+        // number of encoded and rasterized QR codes kept by QRCodeWidget,
+        // every entry holds a bitmap of the widget size
+        #ifndef EEZ_GUI_QR_CODE_CACHE_SIZE
+            #define EEZ_GUI_QR_CODE_CACHE_SIZE 1
+        #endif
+        // number of multiline text layouts (line breaks) kept by drawMultilineText
+        #ifndef EEZ_GUI_MULTILINE_TEXT_LAYOUT_CACHE_SIZE
+            #define EEZ_GUI_MULTILINE_TEXT_LAYOUT_CACHE_SIZE 8
+        #endif
+        // size of the formatted text kept in each DisplayData widget state,
+        // longer texts are formatted on every render
+        #ifndef EEZ_GUI_DISPLAY_DATA_TEXT_CACHE_SIZE
+            #define EEZ_GUI_DISPLAY_DATA_TEXT_CACHE_SIZE 32
+        #endif
+        // collect per frame and per widget type render times (see gui/render_stats.h)
+        #ifndef EEZ_OPTION_GUI_RENDER_STATS
+            #define EEZ_OPTION_GUI_RENDER_STATS 0
+        #endif
     #endif
 #endif
 
+// Simulator without SDL window: frames are rendered only into the memory
+// framebuffer, used for benchmarks and CI on machines without display
+#ifndef EEZ_OPTION_HEADLESS_DISPLAY
+#define EEZ_OPTION_HEADLESS_DISPLAY 0
+#endif
+
+#if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__) && !EEZ_OPTION_HEADLESS_DISPLAY
+#define EEZ_SIMULATOR_SDL 1
+#else
+#define EEZ_SIMULATOR_SDL 0
+#endif
+
 #ifndef EEZ_FOR_LVGL_LZ4_OPTION
 #define EEZ_FOR_LVGL_LZ4_OPTION 1
 #endif
@@ -68,3 +98,17 @@
 #ifndef EEZ_FOR_LVGL_SHA256_OPTION
 #define EEZ_FOR_LVGL_SHA256_OPTION 1
 #endif
+
+// Max. size of the memory used for the decompressed chunks of the chunked assets
+#ifndef EEZ_ASSETS_CHUNKS_CACHE_SIZE
+#define EEZ_ASSETS_CHUNKS_CACHE_SIZE (256 * 1024)
+#endif
+
+// Loading of the main assets by mapping uncompressed assets file into memory (POSIX only)
+#ifndef EEZ_OPTION_MMAP_ASSETS
+    #if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__) && !defined(EEZ_PLATFORM_STM32)
+        #define EEZ_OPTION_MMAP_ASSETS 1
+    #else
+        #define EEZ_OPTION_MMAP_ASSETS 0
+    #endif
+#endif
@@ -19,12 +19,27 @@
 #include <eez/core/memory.h>
 #include <eez/core/debug.h>
 #include <eez/core/assets.h>
+#include <eez/core/assets_chunks.h>
 #include <eez/flow/flow.h>
 
 #if EEZ_FOR_LVGL_LZ4_OPTION
 #include <eez/libs/lz4/lz4.h>
 #endif
 
+#if EEZ_OPTION_MMAP_ASSETS
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <eez/core/util.h>
+#if EEZ_FOR_LVGL_SHA256_OPTION
+extern "C" {
+#include <eez/libs/sha256/sha256.h>
+}
+#endif
+#endif
+
 #if EEZ_OPTION_GUI
 #include <eez/gui/gui.h>
 #include <eez/gui/widget.h>
@@ -36,6 +51,8 @@ using namespace eez::gui;
 #else
 #define SCPI_ERROR_OUT_OF_DEVICE_MEMORY -321
 #define SCPI_ERROR_INVALID_BLOCK_DATA -161
+#define SCPI_ERROR_MASS_STORAGE_ERROR -250
+#define SCPI_ERROR_FILE_NAME_NOT_FOUND -256
 #endif
 
 namespace eez {
@@ -52,6 +69,7 @@ void fixOffsets(Assets *assets);
 bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, Assets *decompressedAssets, uint32_t maxDecompressedAssetsSize, int *err) {
 	uint32_t compressedDataOffset;
 	uint32_t decompressedSize;
+	int compressedSize;
 
 	auto header = (Header *)assetsData;
 
@@ -62,6 +80,18 @@ bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, As
 
 		compressedDataOffset = sizeof(Header);
 		decompressedSize = header->decompressedSize;
+		compressedSize = assetsDataSize - compressedDataOffset;
+	} else if (header->tag == HEADER_TAG_CHUNKED) {
+		// only the main part is decompressed here, chunks are decompressed on demand
+		auto chunkedHeader = (ChunkedHeader *)assetsData;
+
+		decompressedAssets->projectMajorVersion = chunkedHeader->projectMajorVersion;
+		decompressedAssets->projectMinorVersion = chunkedHeader->projectMinorVersion;
+        decompressedAssets->assetsType = chunkedHeader->assetsType;
+
+		compressedDataOffset = sizeof(ChunkedHeader);
+		decompressedSize = chunkedHeader->decompressedSize;
+		compressedSize = chunkedHeader->compressedSize;
 	} else {
 		decompressedAssets->projectMajorVersion = PROJECT_VERSION_V2;
 		decompressedAssets->projectMinorVersion = 0;
@@ -69,6 +99,7 @@ bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, As
 
 		compressedDataOffset = 4;
 		decompressedSize = header->tag;
+		compressedSize = assetsDataSize - compressedDataOffset;
 	}
 
 // disable warning: offsetof within non-standard-layout type ... is conditionally-supported [-Winvalid-offsetof]
@@ -91,8 +122,6 @@ bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, As
 		return false;
 	}
 
-	int compressedSize = assetsDataSize - compressedDataOffset;
-
 #if EEZ_FOR_LVGL_LZ4_OPTION
     int decompressResult = LZ4_decompress_safe(
 		(const char *)(assetsData + compressedDataOffset),
@@ -128,7 +157,7 @@ void allocMemoryForDecompressedAssets(const uint8_t *assetsData, uint32_t assets
 #endif
 
     auto header = (Header *)assetsData;
-    assert (header->tag == HEADER_TAG_COMPRESSED);
+    assert (header->tag == HEADER_TAG_COMPRESSED || header->tag == HEADER_TAG_CHUNKED);
     uint32_t decompressedSize = header->decompressedSize;
 
     decompressedAssetsMemoryBufferSize = decompressedDataOffset + decompressedSize;
@@ -152,10 +181,207 @@ void loadMainAssets(const uint8_t *assets, uint32_t assetsSize) {
         g_mainAssets->external = false;
         auto decompressedSize = decompressAssetsData(assets, assetsSize, g_mainAssets, MAX_DECOMPRESSED_ASSETS_SIZE, nullptr);
         assert(decompressedSize);
+
+        if (header->tag == HEADER_TAG_CHUNKED) {
+            initAssetsChunks(assets, assetsSize);
+        }
     }
     g_isMainAssetsLoaded = true;
 }
 
+#if EEZ_OPTION_MMAP_ASSETS
+
+static void *g_mainAssetsMappedMemory;
+static size_t g_mainAssetsMappedMemorySize;
+
+// mapping replaced by the last loadMainAssetsFromFile, it is still mapped
+// because pages, styles, fonts etc. from it can still be in use
+static void *g_retiredMainAssetsMappedMemory;
+static size_t g_retiredMainAssetsMappedMemorySize;
+
+void releaseRetiredMainAssets() {
+    if (g_retiredMainAssetsMappedMemory) {
+        munmap(g_retiredMainAssetsMappedMemory, g_retiredMainAssetsMappedMemorySize);
+        g_retiredMainAssetsMappedMemory = nullptr;
+        g_retiredMainAssetsMappedMemorySize = 0;
+    }
+}
+
+bool loadMainAssetsFromFile(const char *filePath, int *err) {
+    int fd = ::open(filePath, O_RDONLY);
+    if (fd == -1) {
+        if (err) {
+            *err = SCPI_ERROR_FILE_NAME_NOT_FOUND;
+        }
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(uint32_t) + sizeof(Assets)) {
+        ::close(fd);
+        if (err) {
+            *err = SCPI_ERROR_INVALID_BLOCK_DATA;
+        }
+        return false;
+    }
+
+    // Private writable mapping: pages are shared with the page cache
+    // until something writes into the assets (copy on write).
+    void *memory = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        if (err) {
+            *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+        }
+        return false;
+    }
+
+    if (((Header *)memory)->tag != HEADER_TAG) {
+        munmap(memory, st.st_size);
+        if (err) {
+            *err = SCPI_ERROR_INVALID_BLOCK_DATA;
+        }
+        return false;
+    }
+
+    if (g_mainAssetsMappedMemory) {
+        // the one before is not used since the previous load
+        releaseRetiredMainAssets();
+        g_retiredMainAssetsMappedMemory = g_mainAssetsMappedMemory;
+        g_retiredMainAssetsMappedMemorySize = g_mainAssetsMappedMemorySize;
+    }
+    g_mainAssetsMappedMemory = memory;
+    g_mainAssetsMappedMemorySize = st.st_size;
+
+    g_mainAssets = (Assets *)((uint8_t *)memory + sizeof(uint32_t)/* skip HEADER_TAG*/);
+    g_mainAssetsUncompressed = true;
+    g_isMainAssetsLoaded = true;
+
+    return true;
+}
+
+static bool writeFile(int fd, const void *data, size_t size) {
+    auto p = (const uint8_t *)data;
+    while (size > 0) {
+        auto n = ::write(fd, p, size);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool saveDecompressedAssets(const uint8_t *assets, uint32_t assetsSize, const char *filePath, int *err) {
+    auto header = (Header *)assets;
+    if (header->tag != HEADER_TAG_COMPRESSED) {
+        if (err) {
+            *err = SCPI_ERROR_INVALID_BLOCK_DATA;
+        }
+        return false;
+    }
+
+// disable warning: offsetof within non-standard-layout type ... is conditionally-supported [-Winvalid-offsetof]
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+
+    uint32_t decompressedAssetsSize = offsetof(Assets, settings) + header->decompressedSize;
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+    // this buffer is only temporary and can be much larger than the eez heap, so use system heap
+    auto decompressedAssets = (uint8_t *)::malloc(decompressedAssetsSize);
+    if (!decompressedAssets) {
+        if (err) {
+            *err = SCPI_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+        return false;
+    }
+
+    if (!decompressAssetsData(assets, assetsSize, (Assets *)decompressedAssets, decompressedAssetsSize, err)) {
+        ::free(decompressedAssets);
+        return false;
+    }
+    ((Assets *)decompressedAssets)->external = false;
+
+    // write to temporary file first and then rename it,
+    // so other process never sees partially written file
+    char tmpFilePath[1024];
+    snprintf(tmpFilePath, sizeof(tmpFilePath), "%s.%d.tmp", filePath, (int)getpid());
+
+    bool result = false;
+    int fd = ::open(tmpFilePath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd != -1) {
+        uint32_t tag = HEADER_TAG;
+        result = writeFile(fd, &tag, sizeof(tag)) && writeFile(fd, decompressedAssets, decompressedAssetsSize);
+        result = (::close(fd) == 0) && result;
+        if (result) {
+            result = ::rename(tmpFilePath, filePath) == 0;
+        }
+        if (!result) {
+            ::unlink(tmpFilePath);
+        }
+    }
+
+    ::free(decompressedAssets);
+
+    if (!result && err) {
+        *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+    }
+
+    return result;
+}
+
+static void getAssetsCacheFilePath(const uint8_t *assets, uint32_t assetsSize, const char *cacheDirPath, char *filePath, size_t filePathSize) {
+    char hash[2 * 32 + 1];
+
+#if EEZ_FOR_LVGL_SHA256_OPTION
+    BYTE digest[SHA256_BLOCK_SIZE];
+    SHA256_CTX ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, assets, assetsSize);
+    sha256_final(&ctx, digest);
+    for (int i = 0; i < SHA256_BLOCK_SIZE; i++) {
+        snprintf(hash + 2 * i, 3, "%02x", digest[i]);
+    }
+#else
+    snprintf(hash, sizeof(hash), "%08x%08x", (unsigned)crc32(assets, assetsSize), (unsigned)assetsSize);
+#endif
+
+    snprintf(filePath, filePathSize, "%s/eez-assets-%s.bin", cacheDirPath, hash);
+}
+
+bool loadMainAssetsCached(const uint8_t *assets, uint32_t assetsSize, const char *cacheDirPath, int *err) {
+    auto header = (Header *)assets;
+    if (header->tag != HEADER_TAG_COMPRESSED) {
+        // nothing to decompress, use assets in place
+        loadMainAssets(assets, assetsSize);
+        return true;
+    }
+
+    char filePath[1024];
+    getAssetsCacheFilePath(assets, assetsSize, cacheDirPath, filePath, sizeof(filePath));
+
+    if (loadMainAssetsFromFile(filePath, nullptr)) {
+        return true;
+    }
+
+    if (saveDecompressedAssets(assets, assetsSize, filePath, err) && loadMainAssetsFromFile(filePath, err)) {
+        return true;
+    }
+
+    // cache is not usable (e.g. read only file system), decompress into memory
+    loadMainAssets(assets, assetsSize);
+    return false;
+}
+
+#endif // EEZ_OPTION_MMAP_ASSETS
+
 void unloadExternalAssets() {
 	if (g_externalAssets) {
 #if EEZ_OPTION_GUI
@@ -221,7 +447,11 @@ const gui::FontData *getFontData(int fontID) {
 
 const gui::Bitmap *getBitmap(int bitmapID) {
 	if (bitmapID > 0) {
-		return g_mainAssets->bitmaps[bitmapID - 1];
+		auto bitmap = g_mainAssets->bitmaps[bitmapID - 1];
+		if (bitmap->flags & BITMAP_FLAG_CHUNKED) {
+			return loadChunkedBitmap(bitmap);
+		}
+		return bitmap;
 	} else if (bitmapID < 0) {
 		if (g_externalAssets == nullptr) {
 			return nullptr;
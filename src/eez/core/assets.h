@@ -19,6 +19,7 @@ namespace eez {
 
 static const uint32_t HEADER_TAG = 0x5A45457E; // "~EEZ"
 static const uint32_t HEADER_TAG_COMPRESSED = 0x7A65657E; // "~eez"
+static const uint32_t HEADER_TAG_CHUNKED = 0x6365657E; // "~eec"
 
 static const uint8_t PROJECT_VERSION_V2 = 2;
 static const uint8_t PROJECT_VERSION_V3 = 3;
@@ -38,6 +39,31 @@ struct Header {
 	uint32_t decompressedSize;
 };
 
+// Chunked assets (HEADER_TAG_CHUNKED) are laid out like this:
+//   - ChunkedHeader
+//   - LZ4 compressed main part (compressedSize bytes, decompressedSize bytes after decompression)
+//   - numChunks times AssetsChunk
+//   - independently LZ4 compressed chunks
+// Main part is the same as in HEADER_TAG_COMPRESSED assets, except that pixels of some
+// bitmaps and glyphs are moved into the chunks (see BITMAP_FLAG_CHUNKED and GLYPH_FLAG_CHUNKED).
+// Chunks are decompressed on first use into the cache (see assets_chunks.h).
+struct ChunkedHeader {
+	uint32_t tag; // HEADER_TAG_CHUNKED
+	uint8_t projectMajorVersion;
+	uint8_t projectMinorVersion;
+	uint8_t assetsType;
+    uint8_t reserved;
+	uint32_t decompressedSize;
+	uint32_t compressedSize;
+	uint32_t numChunks;
+};
+
+struct AssetsChunk {
+	uint32_t offset; // from the start of the assets data
+	uint32_t compressedSize;
+	uint32_t decompressedSize;
+};
+
 extern bool g_isMainAssetsLoaded;
 struct Assets;
 extern Assets *g_mainAssets;
@@ -294,12 +320,15 @@ struct GlyphData {
 	uint8_t height;    // BBX height
 	int8_t x;          // BBX xoffset
 	int8_t y;          // BBX yoffset
-    uint8_t reserved1;
+    uint8_t flags;     // GLYPH_FLAG_...
     uint8_t reserved2;
     uint8_t reserved3;
 	uint8_t pixels[1];
 };
 
+// pixels are stored in the chunk, index of the chunk (uint32_t) is stored in the place of pixels
+#define GLYPH_FLAG_CHUNKED (1 << 0)
+
 struct GlyphsGroup {
     uint32_t encoding;
     uint32_t glyphIndex;
@@ -323,11 +352,14 @@ struct Bitmap {
     int16_t w;
     int16_t h;
     int16_t bpp;
-    int16_t reserved;
+    int16_t flags; // BITMAP_FLAG_...
     AssetsPtr<const char> name;
     const uint8_t pixels[1];
 };
 
+// pixels are stored in the chunk, index of the chunk (uint32_t) is stored in the place of pixels
+#define BITMAP_FLAG_CHUNKED (1 << 0)
+
 } // namespace gui
 
 #endif // EEZ_OPTION_GUI
@@ -460,6 +492,29 @@ bool decompressAssetsData(const uint8_t *assetsData, uint32_t assetsDataSize, As
 
 void loadMainAssets(const uint8_t *assets, uint32_t assetsSize);
 bool loadExternalAssets(const char *filePath, int *err);
+
+#if EEZ_OPTION_MMAP_ASSETS
+// Maps uncompressed assets file (i.e. starting with HEADER_TAG) into memory and uses it
+// as main assets without copying. Pages are loaded by the OS on first access.
+// Previously mapped main assets are not unmapped immediately, because they can
+// still be in use, that happens on the next load or releaseRetiredMainAssets.
+bool loadMainAssetsFromFile(const char *filePath, int *err);
+
+// Unmaps the main assets replaced by the last loadMainAssetsFromFile.
+// Call it when nothing refers to them anymore, e.g. after the GUI has switched
+// to the new assets or on shutdown.
+void releaseRetiredMainAssets();
+
+// Decompresses assets and writes them in the uncompressed format,
+// so they can be loaded with loadMainAssetsFromFile.
+bool saveDecompressedAssets(const uint8_t *assets, uint32_t assetsSize, const char *filePath, int *err);
+
+// Same as loadMainAssets, but compressed assets are decompressed only once into
+// the cache directory (file name is the hash of the compressed assets) and mapped
+// from there on every subsequent start. If cache can't be used assets are
+// decompressed into memory as usual, and false is returned with the reason in err.
+bool loadMainAssetsCached(const uint8_t *assets, uint32_t assetsSize, const char *cacheDirPath, int *err);
+#endif
 void unloadExternalAssets();
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -469,6 +524,8 @@ const gui::PageAsset *getPageAsset(int pageId);
 const gui::PageAsset* getPageAsset(int pageId, gui::WidgetCursor& widgetCursor);
 const gui::Style *getStyle(int styleID);
 const gui::FontData *getFontData(int fontID);
+// For chunked bitmaps the returned pointer is valid only until the next
+// getBitmap or Font::getGlyph call, nullptr if the chunk can't be loaded.
 const gui::Bitmap *getBitmap(int bitmapID);
 const int getBitmapIdByName(const char *bitmapName);
 #endif
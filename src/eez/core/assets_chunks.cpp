@@ -0,0 +1,237 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <eez/conf-internal.h>
+
+#include <string.h>
+
+#include <eez/core/alloc.h>
+#include <eez/core/assets_chunks.h>
+
+#if EEZ_FOR_LVGL_LZ4_OPTION
+#include <eez/libs/lz4/lz4.h>
+#endif
+
+namespace eez {
+
+struct CacheEntry {
+    CacheEntry *prev; // more recently used
+    CacheEntry *next; // less recently used
+    uint32_t chunkIndex;
+    uint32_t size;
+    uint8_t data[1];
+};
+
+static const uint8_t *g_assetsData;
+static const AssetsChunk *g_chunks;
+static uint32_t g_numChunks;
+
+// for each chunk, its entry in the cache or nullptr
+static CacheEntry **g_cacheEntries;
+
+// least recently used list
+static CacheEntry *g_first;
+static CacheEntry *g_last;
+
+static AssetsChunksCacheStats g_stats;
+
+static void removeFromList(CacheEntry *entry) {
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        g_first = entry->next;
+    }
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        g_last = entry->prev;
+    }
+}
+
+static void addToListFront(CacheEntry *entry) {
+    entry->prev = nullptr;
+    entry->next = g_first;
+    if (g_first) {
+        g_first->prev = entry;
+    } else {
+        g_last = entry;
+    }
+    g_first = entry;
+}
+
+static void evict(CacheEntry *entry) {
+    removeFromList(entry);
+    g_cacheEntries[entry->chunkIndex] = nullptr;
+    g_stats.cacheSize -= entry->size;
+    g_stats.evictions++;
+    free(entry);
+}
+
+static void freeCache() {
+    while (g_last) {
+        evict(g_last);
+    }
+    if (g_cacheEntries) {
+        free(g_cacheEntries);
+        g_cacheEntries = nullptr;
+    }
+}
+
+void initAssetsChunks(const uint8_t *assetsData, uint32_t assetsDataSize) {
+    freeCache();
+
+    g_assetsData = nullptr;
+    g_chunks = nullptr;
+    g_numChunks = 0;
+
+    auto header = (const ChunkedHeader *)assetsData;
+    if (header->tag != HEADER_TAG_CHUNKED) {
+        return;
+    }
+
+    auto chunksOffset = sizeof(ChunkedHeader) + header->compressedSize;
+    if (chunksOffset + header->numChunks * sizeof(AssetsChunk) > assetsDataSize) {
+        return;
+    }
+
+    g_cacheEntries = (CacheEntry **)alloc(header->numChunks * sizeof(CacheEntry *), 0x6b1f0d3a);
+    if (!g_cacheEntries) {
+        return;
+    }
+    for (uint32_t i = 0; i < header->numChunks; i++) {
+        g_cacheEntries[i] = nullptr;
+    }
+
+    g_assetsData = assetsData;
+    g_chunks = (const AssetsChunk *)(assetsData + chunksOffset);
+    g_numChunks = header->numChunks;
+
+    resetAssetsChunksCacheStats();
+}
+
+uint8_t *getAssetsChunk(uint32_t chunkIndex, const void *prefix, uint32_t prefixSize) {
+    if (chunkIndex >= g_numChunks) {
+        return nullptr;
+    }
+
+    auto entry = g_cacheEntries[chunkIndex];
+    if (entry) {
+        g_stats.hits++;
+        if (entry != g_first) {
+            removeFromList(entry);
+            addToListFront(entry);
+        }
+        return entry->data;
+    }
+
+    g_stats.misses++;
+
+    auto &chunk = g_chunks[chunkIndex];
+    uint32_t size = prefixSize + chunk.decompressedSize;
+
+    // Make room, but always keep the most recently used entry,
+    // because pointer to it can still be in use by the caller.
+    while (g_last && g_last != g_first && g_stats.cacheSize + size > EEZ_ASSETS_CHUNKS_CACHE_SIZE) {
+        evict(g_last);
+    }
+
+    entry = (CacheEntry *)alloc(offsetof(CacheEntry, data) + size, 0x2c84e1f5);
+    if (!entry && g_last && g_last != g_first) {
+        // out of memory, try again without the least recently used entry
+        evict(g_last);
+        entry = (CacheEntry *)alloc(offsetof(CacheEntry, data) + size, 0x2c84e1f5);
+    }
+    if (!entry) {
+        return nullptr;
+    }
+
+#if EEZ_FOR_LVGL_LZ4_OPTION
+    int decompressResult = LZ4_decompress_safe(
+        (const char *)(g_assetsData + chunk.offset),
+        (char *)entry->data + prefixSize,
+        chunk.compressedSize,
+        chunk.decompressedSize
+    );
+    if (decompressResult != (int)chunk.decompressedSize) {
+        free(entry);
+        return nullptr;
+    }
+#else
+    free(entry);
+    return nullptr;
+#endif
+
+    memcpy(entry->data, prefix, prefixSize);
+
+    entry->chunkIndex = chunkIndex;
+    entry->size = size;
+    addToListFront(entry);
+    g_cacheEntries[chunkIndex] = entry;
+
+    g_stats.cacheSize += size;
+    if (g_stats.cacheSize > g_stats.maxCacheSize) {
+        g_stats.maxCacheSize = g_stats.cacheSize;
+    }
+    g_stats.decompressedBytes += chunk.decompressedSize;
+
+    return entry->data;
+}
+
+void getAssetsChunksCacheStats(AssetsChunksCacheStats &stats) {
+    stats = g_stats;
+}
+
+void resetAssetsChunksCacheStats() {
+    g_stats.hits = 0;
+    g_stats.misses = 0;
+    g_stats.evictions = 0;
+    g_stats.decompressedBytes = 0;
+    g_stats.maxCacheSize = g_stats.cacheSize;
+}
+
+#if EEZ_OPTION_GUI
+
+// disable warning: offsetof within non-standard-layout type ... is conditionally-supported [-Winvalid-offsetof]
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+
+const gui::Bitmap *loadChunkedBitmap(const gui::Bitmap *bitmap) {
+    uint32_t chunkIndex;
+    memcpy(&chunkIndex, bitmap->pixels, sizeof(uint32_t));
+
+    auto loadedBitmap = (gui::Bitmap *)getAssetsChunk(chunkIndex, bitmap, offsetof(gui::Bitmap, pixels));
+    if (loadedBitmap) {
+        loadedBitmap->flags &= ~BITMAP_FLAG_CHUNKED;
+        // name is relative pointer, so it must be fixed for the new location
+        loadedBitmap->name = (const char *)bitmap->name;
+    }
+    return loadedBitmap;
+}
+
+const gui::GlyphData *loadChunkedGlyph(const gui::GlyphData *glyphData) {
+    uint32_t chunkIndex;
+    memcpy(&chunkIndex, glyphData->pixels, sizeof(uint32_t));
+
+    auto loadedGlyphData = (gui::GlyphData *)getAssetsChunk(chunkIndex, glyphData, offsetof(gui::GlyphData, pixels));
+    if (loadedGlyphData) {
+        loadedGlyphData->flags &= ~GLYPH_FLAG_CHUNKED;
+    }
+    return loadedGlyphData;
+}
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+#endif // EEZ_OPTION_GUI
+
+} // namespace eez
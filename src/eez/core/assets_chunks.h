@@ -0,0 +1,42 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <eez/core/assets.h>
+
+namespace eez {
+
+struct AssetsChunksCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t decompressedBytes; // total number of bytes decompressed on cache misses
+    uint32_t cacheSize; // currently used
+    uint32_t maxCacheSize;
+};
+
+// Registers chunks of the chunked assets. Assets data must stay valid
+// while assets are used, because chunks are decompressed from it on demand.
+void initAssetsChunks(const uint8_t *assetsData, uint32_t assetsDataSize);
+
+// Returns chunk decompressed into the cache, prefixed with prefixSize bytes copied from the prefix.
+// Returned memory is valid until the next call, it can be evicted after that.
+uint8_t *getAssetsChunk(uint32_t chunkIndex, const void *prefix, uint32_t prefixSize);
+
+void getAssetsChunksCacheStats(AssetsChunksCacheStats &stats);
+void resetAssetsChunksCacheStats();
+
+#if EEZ_OPTION_GUI
+const gui::Bitmap *loadChunkedBitmap(const gui::Bitmap *bitmap);
+const gui::GlyphData *loadChunkedGlyph(const gui::GlyphData *glyphData);
+#endif
+
+} // namespace eez
@@ -12,13 +12,15 @@
 
 #include <stdint.h>
 
+#include <eez/conf-internal.h>
+
 #if defined(EEZ_PLATFORM_STM32)
 #if OPTION_KEYBOARD
 #include <usbh_hid.h>
 #endif
 #endif
 
-#if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__)
+#if EEZ_SIMULATOR_SDL
 #include <SDL.h>
 #endif
 
@@ -31,7 +33,7 @@ void onKeyboardEvent(USBH_HandleTypeDef *phost);
 #endif
 #endif
 
-#if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__)
+#if EEZ_SIMULATOR_SDL
 void onKeyboardEvent(SDL_KeyboardEvent *key);
 #endif
 
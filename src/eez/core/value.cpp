@@ -17,6 +17,7 @@
 #include <ctype.h>
 
 #include <eez/core/util.h>
+#include <eez/core/utf8.h>
 #include <eez/core/value.h>
 #include <eez/core/vars.h>
 
@@ -852,6 +853,96 @@ const char *Value::getString() const {
 	return nullptr;
 }
 
+int Value::getStringLength() const {
+    auto value = getValue();
+	if (value.type == VALUE_TYPE_STRING_REF) {
+		return (int)((StringRef *)value.refValue)->length;
+	}
+	if (value.type == VALUE_TYPE_STRING && value.strValue) {
+		return (int)strlen(value.strValue);
+	}
+	return 0;
+}
+
+int32_t Value::getStringCodePointAt(int index) const {
+    if (index < 0) {
+        return 0;
+    }
+
+    auto value = getValue();
+
+    const char *str;
+	if (value.type == VALUE_TYPE_STRING_REF) {
+		str = ((StringRef *)value.refValue)->getCodePoint(index);
+	} else {
+        str = value.getString();
+        if (str) {
+            utf8_int32_t codePoint;
+            for (; index > 0 && *str; index--) {
+                str = utf8codepoint(str, &codePoint);
+            }
+        }
+    }
+
+    utf8_int32_t codePoint = 0;
+    if (str) {
+        utf8codepoint(str, &codePoint);
+    }
+    return codePoint;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const uint32_t STRING_CODE_POINT_INDEX_MIN_LENGTH = 64;
+static const int STRING_CODE_POINT_INDEX_STEP = 32;
+
+void StringRef::indexCodePoints() {
+    if (length >= STRING_CODE_POINT_INDEX_MIN_LENGTH) {
+        // there is at most one code point per byte
+        codePointIndex = (uint32_t *)alloc((length / STRING_CODE_POINT_INDEX_STEP + 1) * sizeof(uint32_t), 0x5c0e2a71);
+    }
+
+    numCodePoints = 0;
+    for (const char *p = str; *p; numCodePoints++) {
+        if (codePointIndex && numCodePoints % STRING_CODE_POINT_INDEX_STEP == 0) {
+            codePointIndex[numCodePoints / STRING_CODE_POINT_INDEX_STEP] = p - str;
+        }
+        utf8_int32_t codePoint;
+        p = utf8codepoint(p, &codePoint);
+    }
+
+    if (codePointIndex && (uint32_t)numCodePoints == length) {
+        // ASCII, code point index is byte offset
+        eez::free(codePointIndex);
+        codePointIndex = nullptr;
+    }
+}
+
+const char *StringRef::getCodePoint(int index) {
+    if (numCodePoints == -1) {
+        indexCodePoints();
+    }
+
+    if (index < 0 || index >= numCodePoints) {
+        return nullptr;
+    }
+
+    if ((uint32_t)numCodePoints == length) {
+        return str + index;
+    }
+
+    const char *p = str;
+    if (codePointIndex) {
+        p += codePointIndex[index / STRING_CODE_POINT_INDEX_STEP];
+        index %= STRING_CODE_POINT_INDEX_STEP;
+    }
+    for (; index > 0; index--) {
+        utf8_int32_t codePoint;
+        p = utf8codepoint(p, &codePoint);
+    }
+    return p;
+}
+
 const ArrayValue *Value::getArray() const {
     if (type == VALUE_TYPE_ARRAY) {
         return arrayValue;
@@ -1284,6 +1375,7 @@ Value Value::makeStringRef(const char *str, int len, uint32_t id) {
 
     stringCopyLength(stringRef->str, len + 1, str, len);
 	stringRef->str[len] = 0;
+    stringRef->length = len;
 
     stringRef->refCounter = 1;
 
@@ -1302,15 +1394,19 @@ Value Value::concatenateString(const Value &str1, const Value &str2) {
 		return Value(0, VALUE_TYPE_NULL);
 	}
 
-    auto newStrLen = strlen(str1.getString()) + strlen(str2.getString()) + 1;
+    auto str1Len = str1.getStringLength();
+    auto str2Len = str2.getStringLength();
+    auto newStrLen = str1Len + str2Len + 1;
     stringRef->str = (char *)alloc(newStrLen, 0xb5320162);
     if (stringRef->str == nullptr) {
         ObjectAllocator<StringRef>::deallocate(stringRef);
         return Value(0, VALUE_TYPE_NULL);
     }
 
-    stringCopy(stringRef->str, newStrLen, str1.getString());
-    stringAppendString(stringRef->str, newStrLen, str2.getString());
+    memcpy(stringRef->str, str1.getString(), str1Len);
+    memcpy(stringRef->str + str1Len, str2.getString(), str2Len);
+    stringRef->str[str1Len + str2Len] = 0;
+    stringRef->length = str1Len + str2Len;
 
     stringRef->refCounter = 1;
 
@@ -1323,6 +1419,124 @@ Value Value::concatenateString(const Value &str1, const Value &str2) {
 	return value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+struct StringSlices;
+
+// Part of the string split by Value::splitString, str points into the text shared by all parts.
+struct StringSliceRef : public StringRef {
+    StringSlices *slices;
+
+    ~StringSliceRef() {
+        str = nullptr; // not owned
+    }
+
+    void release() override;
+};
+
+// Header of the single allocation holding all the parts and the text of the split string.
+struct StringSlices {
+    uint32_t numSlicesInUse;
+};
+
+void StringSliceRef::release() {
+    auto slices = this->slices;
+    this->~StringSliceRef();
+    if (--slices->numSlicesInUse == 0) {
+        eez::free(slices);
+    }
+}
+
+Value Value::splitString(const char *str, int strLen, const char *delim, uint32_t id) {
+    bool isDelim[256] = {};
+    for (const char *p = delim; *p; p++) {
+        isDelim[(uint8_t)*p] = true;
+    }
+
+    // find start and end of all the parts in one scan, like strtok there are no empty parts
+    static const int NUM_LOCAL_PARTS = 32;
+    uint32_t localParts[2 * NUM_LOCAL_PARTS];
+    uint32_t *parts = localParts;
+    int maxParts = NUM_LOCAL_PARTS;
+    int numParts = 0;
+
+    for (int i = 0; i < strLen; ) {
+        while (i < strLen && isDelim[(uint8_t)str[i]]) {
+            i++;
+        }
+        if (i == strLen) {
+            break;
+        }
+
+        int start = i;
+        while (i < strLen && !isDelim[(uint8_t)str[i]]) {
+            i++;
+        }
+
+        if (numParts == maxParts) {
+            auto newParts = (uint32_t *)alloc(2 * 2 * maxParts * sizeof(uint32_t), id + 1);
+            if (!newParts) {
+                if (parts != localParts) {
+                    eez::free(parts);
+                }
+                return Value(0, VALUE_TYPE_NULL);
+            }
+            memcpy(newParts, parts, 2 * numParts * sizeof(uint32_t));
+            if (parts != localParts) {
+                eez::free(parts);
+            }
+            parts = newParts;
+            maxParts *= 2;
+        }
+
+        parts[2 * numParts] = start;
+        parts[2 * numParts + 1] = i;
+        numParts++;
+    }
+
+    auto arrayValue = makeArrayRef(numParts, VALUE_TYPE_STRING, id);
+
+    if (arrayValue.type != VALUE_TYPE_NULL && numParts > 0) {
+        // header, parts and text in one allocation
+        size_t partsOffset = (sizeof(StringSlices) + alignof(StringSliceRef) - 1) / alignof(StringSliceRef) * alignof(StringSliceRef);
+        size_t textOffset = partsOffset + numParts * sizeof(StringSliceRef);
+
+        auto slices = (StringSlices *)alloc(textOffset + strLen + 1, id + 2);
+        if (slices) {
+            slices->numSlicesInUse = numParts;
+
+            auto text = (char *)slices + textOffset;
+            memcpy(text, str, strLen);
+            text[strLen] = 0;
+
+            auto array = arrayValue.getArray();
+            auto sliceRefs = (StringSliceRef *)((uint8_t *)slices + partsOffset);
+
+            for (int i = 0; i < numParts; i++) {
+                auto stringRef = new (sliceRefs + i) StringSliceRef;
+                stringRef->refCounter = 1;
+                stringRef->slices = slices;
+                stringRef->str = text + parts[2 * i];
+                stringRef->length = parts[2 * i + 1] - parts[2 * i];
+                stringRef->str[stringRef->length] = 0;
+
+                Value &value = array->values[i];
+                value.type = VALUE_TYPE_STRING_REF;
+                value.options = VALUE_OPTIONS_REF;
+                value.refValue = stringRef;
+            }
+        } else {
+            arrayValue = Value(0, VALUE_TYPE_NULL);
+        }
+    }
+
+    if (parts != localParts) {
+        eez::free(parts);
+    }
+
+    return arrayValue;
+}
+
 Value Value::makeArrayRef(int arraySize, int arrayType, uint32_t id) {
     auto ptr = alloc(sizeof(ArrayValueRef) + (arraySize > 0 ? arraySize - 1 : 0) * sizeof(Value), id);
 	if (ptr == nullptr) {
@@ -85,6 +85,11 @@ struct PairOfInt16Value {
 struct Ref {
 	uint32_t refCounter;
     virtual ~Ref() {}
+
+    // called when refCounter drops to 0
+    virtual void release() {
+        ObjectAllocator<Ref>::deallocate(this);
+    }
 };
 
 struct ArrayValue;
@@ -236,7 +241,7 @@ struct Value {
     void freeRef() {
 		if (options & VALUE_OPTIONS_REF) {
 			if (--refValue->refCounter == 0) {
-                ObjectAllocator<Ref>::deallocate(refValue);
+                refValue->release();
 			}
 		}/* else if (type == VALUE_TYPE_VALUE_PTR) {
             if (pValueValue->options & VALUE_OPTIONS_REF) {
@@ -419,6 +424,8 @@ struct Value {
 	}
 
 	const char *getString() const;
+    int getStringLength() const; // in bytes, constant time for VALUE_TYPE_STRING_REF
+    int32_t getStringCodePointAt(int index) const; // 0 if index is out of range
 
     const ArrayValue *getArray() const;
     ArrayValue *getArray();
@@ -508,6 +515,7 @@ struct Value {
 
 	static Value makeStringRef(const char *str, int len, uint32_t id);
 	static Value concatenateString(const Value &str1, const Value &str2);
+    static Value splitString(const char *str, int strLen, const char *delim, uint32_t id);
 
     static Value makeArrayRef(int arraySize, int arrayType, uint32_t id);
     static Value makeArrayElementRef(Value arrayValue, int elementIndex, uint32_t id);
@@ -564,8 +572,23 @@ struct StringRef : public Ref {
         if (str) {
             eez::free(str);
         }
+        if (codePointIndex) {
+            eez::free(codePointIndex);
+        }
     }
 	char *str;
+    uint32_t length; // in bytes, set when the string is created
+
+    // counted on first code point access
+    int32_t numCodePoints = -1;
+    // byte offsets of every STRING_CODE_POINT_INDEX_STEP-th code point, only for long non-ASCII strings
+    uint32_t *codePointIndex = nullptr;
+
+    // returns nullptr if index is out of range
+    const char *getCodePoint(int index);
+
+private:
+    void indexCodePoints();
 };
 
 struct ArrayValue {
@@ -17,24 +17,19 @@
 #include <eez/flow/components.h>
 #include <eez/flow/expression.h>
 #include <eez/flow/private.h>
+#include <eez/flow/sample_batch.h>
 #include <eez/flow/components/line_chart_widget.h>
 
 namespace eez {
 namespace flow {
 
 LineChartWidgetComponenentExecutionState::LineChartWidgetComponenentExecutionState()
-    : data(nullptr)
+    : lineLabels(nullptr), data(nullptr)
 {
 }
 
 LineChartWidgetComponenentExecutionState::~LineChartWidgetComponenentExecutionState() {
-    if (data != nullptr) {
-        auto xValues = (Value *)data;
-        for (uint32_t i = 0; i < maxPoints; i++) {
-            (xValues + i)->~Value();
-        }
-        eez::free(data);
-    }
+    eez::free(data);
 
     for (uint32_t i = 0; i < numLines; i++) {
 		(lineLabels + i)->~Value();
@@ -46,55 +41,154 @@ void LineChartWidgetComponenentExecutionState::init(uint32_t numLines_, uint32_t
     numLines = numLines_;
     maxPoints = maxPoints_;
 
-    data = eez::alloc(maxPoints * sizeof(Value) + maxPoints * numLines * sizeof(float), 0xe4945fea);
+    uint32_t numDeques = 2 * (1 + numLines);
+
+    data = eez::alloc(
+        maxPoints * sizeof(double) +
+        numDeques * sizeof(LineChartMonotonicDeque) +
+        (numLines * maxPoints + numLines) * sizeof(float) +
+        numDeques * maxPoints * sizeof(uint32_t) +
+        maxPoints * sizeof(uint8_t),
+        0xe4945fea
+    );
+
+    xValues = (double *)data;
+    deques = (LineChartMonotonicDeque *)(xValues + maxPoints);
+    yValues = (float *)(deques + numDeques);
+    evalYValues = yValues + numLines * maxPoints;
+    auto dequeItems = (uint32_t *)(evalYValues + numLines);
+    xIsDate = (uint8_t *)(dequeItems + numDeques * maxPoints);
+
+    for (uint32_t i = 0; i < numDeques; i++) {
+        deques[i].items = dequeItems + i * maxPoints;
+    }
 
-    auto xValues = (Value *)data;
-    for (uint32_t i = 0; i < maxPoints; i++) {
-		new (xValues + i) Value();
+    lineLabels = (Value *)eez::alloc(numLines * sizeof(Value), 0xe8afd215);
+    for (uint32_t i = 0; i < numLines; i++) {
+		new (lineLabels + i) Value();
 	}
 
+    reset();
+}
+
+void LineChartWidgetComponenentExecutionState::reset() {
     numPoints = 0;
     startPointIndex = 0;
 
-    lineLabels = (Value *)eez::alloc(numLines * sizeof(Value), 0xe8afd215);
-    for (uint32_t i = 0; i < numLines; i++) {
-		new (lineLabels + i) Value();
-	}
+    for (uint32_t i = 0; i < 2 * (1 + numLines); i++) {
+        deques[i].reset();
+    }
 
     updated = true;
 }
 
-Value LineChartWidgetComponenentExecutionState::getX(int pointIndex) {
-    auto xValues = (Value *)data;
-    return xValues[pointIndex];
+void LineChartWidgetComponenentExecutionState::appendPoint(double x, bool xIsDate_, const float *y) {
+    uint32_t pointIndex;
+
+    if (numPoints < maxPoints) {
+        pointIndex = (startPointIndex + numPoints) % maxPoints;
+        numPoints++;
+    } else {
+        // the oldest point is overwritten
+        pointIndex = startPointIndex;
+        startPointIndex = (startPointIndex + 1) % maxPoints;
+
+        for (uint32_t i = 0; i < 2 * (1 + numLines); i++) {
+            deques[i].evict(pointIndex, maxPoints);
+        }
+    }
+
+    xValues[pointIndex] = x;
+    xIsDate[pointIndex] = xIsDate_ ? 1 : 0;
+    if (!isNaN(x)) {
+        deques[0].push<double, true>(xValues, pointIndex, maxPoints);
+        deques[1].push<double, false>(xValues, pointIndex, maxPoints);
+    }
+
+    for (uint32_t lineIndex = 0; lineIndex < numLines; lineIndex++) {
+        auto column = yValues + lineIndex * maxPoints;
+        column[pointIndex] = y[lineIndex];
+        if (!isNaN(y[lineIndex])) {
+            deques[2 + 2 * lineIndex].push<float, true>(column, pointIndex, maxPoints);
+            deques[3 + 2 * lineIndex].push<float, false>(column, pointIndex, maxPoints);
+        }
+    }
 }
 
-void LineChartWidgetComponenentExecutionState::setX(int pointIndex, Value& value) {
-    auto xValues = (Value *)data;
-    xValues[pointIndex] = value;
+void LineChartWidgetComponenentExecutionState::appendPoints(const double *x, bool xIsDate_, const float *y, uint32_t count) {
+    if (count > maxPoints) {
+        // points that would be evicted by the same batch are skipped
+        x += count - maxPoints;
+        y += (count - maxPoints) * numLines;
+        count = maxPoints;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        appendPoint(x[i], xIsDate_, y + i * numLines);
+    }
+
+    if (count > 0) {
+        updated = true;
+    }
 }
 
-float LineChartWidgetComponenentExecutionState::getY(int pointIndex, int lineIndex) {
-    auto yValues = (float *)((Value *)data + maxPoints);
-    return *(yValues + pointIndex * numLines + lineIndex);
+bool LineChartWidgetComponenentExecutionState::appendSampleBatch(const SampleBatch *sampleBatch) {
+    auto stride = sampleBatch->numValuesPerSample;
+    if (stride != 1 + numLines) {
+        return false;
+    }
+
+    bool xIsDate_ = (sampleBatch->flags & SAMPLE_BATCH_FLAG_X_IS_DATE) != 0;
+
+    uint32_t count = sampleBatch->numSamples;
+    uint32_t first = count > maxPoints ? count - maxPoints : 0;
+
+    for (uint32_t i = first; i < count; i++) {
+        auto sample = sampleBatch->values + i * stride;
+        for (uint32_t lineIndex = 0; lineIndex < numLines; lineIndex++) {
+            evalYValues[lineIndex] = (float)sample[1 + lineIndex];
+        }
+        appendPoint(sample[0], xIsDate_, evalYValues);
+    }
+
+    if (count > 0) {
+        updated = true;
+    }
+
+    return true;
 }
 
-void LineChartWidgetComponenentExecutionState::setY(int pointIndex, int lineIndex, float value) {
-    auto yValues = (float *)((Value *)data + maxPoints);
-    *(yValues + pointIndex * numLines + lineIndex) = value;
+bool LineChartWidgetComponenentExecutionState::getXRange(double &min, double &max) {
+    if (deques[0].count == 0) {
+        return false;
+    }
+    min = xValues[deques[0].front()];
+    max = xValues[deques[1].front()];
+    return true;
 }
 
-bool LineChartWidgetComponenentExecutionState::onInputValue(FlowState *flowState, unsigned componentIndex) {
-    auto component = (LineChartWidgetComponenent *)flowState->flow->components[componentIndex];
+bool LineChartWidgetComponenentExecutionState::getYRange(double &min, double &max) {
+    bool result = false;
+    for (uint32_t lineIndex = 0; lineIndex < numLines; lineIndex++) {
+        auto &minDeque = deques[2 + 2 * lineIndex];
+        if (minDeque.count == 0) {
+            continue;
+        }
 
-    uint32_t pointIndex;
+        auto column = yValues + lineIndex * maxPoints;
+        double lineMin = column[minDeque.front()];
+        double lineMax = column[deques[3 + 2 * lineIndex].front()];
 
-    if (numPoints < component->maxPoints) {
-        pointIndex = numPoints++;
-    } else {
-        startPointIndex = (startPointIndex + 1) % component->maxPoints;
-        pointIndex = (startPointIndex + component->maxPoints - 1) % component->maxPoints;
+        if (!result || lineMin < min) min = lineMin;
+        if (!result || lineMax > max) max = lineMax;
+
+        result = true;
     }
+    return result;
+}
+
+bool LineChartWidgetComponenentExecutionState::onInputValue(FlowState *flowState, unsigned componentIndex) {
+    auto component = (LineChartWidgetComponenent *)flowState->flow->components[componentIndex];
 
     Value value;
     if (!evalExpression(flowState, componentIndex, component->xValue, value, "Failed to evaluate x value in LineChartWidget")) {
@@ -102,13 +196,13 @@ bool LineChartWidgetComponenentExecutionState::onInputValue(FlowState *flowState
     }
 
     int err;
-    value.toDouble(&err);
+    double x = value.toDouble(&err);
     if (err) {
         throwError(flowState, componentIndex, "X value not an number or date");
         return false;
     }
 
-    setX(pointIndex, value);
+    bool xIsDate_ = value.getType() == VALUE_TYPE_DATE;
 
     for (uint32_t lineIndex = 0; lineIndex < numLines; lineIndex++) {
         char errorMessage[256];
@@ -119,16 +213,16 @@ bool LineChartWidgetComponenentExecutionState::onInputValue(FlowState *flowState
         }
 
         int err;
-        auto y = value.toFloat(&err);
+        evalYValues[lineIndex] = value.toFloat(&err);
         if (err) {
             snprintf(errorMessage, sizeof(errorMessage), "Can't convert line value no. %d to float", (int)(lineIndex + 1));
             throwError(flowState, componentIndex, errorMessage);
             return false;
         }
-
-        setY(pointIndex, lineIndex, y);
     }
 
+    appendPoint(x, xIsDate_, evalYValues);
+
     return true;
 }
 
@@ -158,9 +252,7 @@ void executeLineChartWidgetComponent(FlowState *flowState, unsigned componentInd
 
     if (flowState->values[component->inputs[resetInputIndex]].type != VALUE_TYPE_UNDEFINED) {
         // reset
-        executionState->numPoints = 0;
-        executionState->startPointIndex = 0;
-        executionState->updated = true;
+        executionState->reset();
 
         clearInputValue(flowState, component->inputs[resetInputIndex]);
     }
@@ -170,12 +262,19 @@ void executeLineChartWidgetComponent(FlowState *flowState, unsigned componentInd
     auto inputValue = flowState->values[valueInputIndexInFlow];
     if (inputValue.type != VALUE_TYPE_UNDEFINED) {
         // data
-        if (inputValue.isArray() && inputValue.getArray()->arrayType == defs_v3::ARRAY_TYPE_ANY) {
+        auto sampleBatch = getSampleBatch(inputValue);
+        if (sampleBatch) {
+            // samples are appended directly, x and line value expressions are not used
+            if (!executionState->appendSampleBatch(sampleBatch)) {
+                throwError(flowState, componentIndex, "Sample batch doesn't match the number of lines in LineChartWidget");
+            }
+        } else if (inputValue.isArray() && inputValue.getArray()->arrayType == defs_v3::ARRAY_TYPE_ANY) {
             auto array = inputValue.getArray();
             bool updated = false;
-            executionState->startPointIndex = 0;
-            executionState->numPoints = 0;
-            for (uint32_t elementIndex = 0; elementIndex < array->arraySize; elementIndex++) {
+            executionState->reset();
+            // elements that would be pushed out of the buffer by this same array are not evaluated
+            uint32_t firstElementIndex = array->arraySize > executionState->maxPoints ? array->arraySize - executionState->maxPoints : 0;
+            for (uint32_t elementIndex = firstElementIndex; elementIndex < array->arraySize; elementIndex++) {
                 flowState->values[valueInputIndexInFlow] = array->values[elementIndex];
                 if (executionState->onInputValue(flowState, componentIndex)) {
                     updated = true;
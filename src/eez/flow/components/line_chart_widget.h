@@ -15,6 +15,8 @@
 namespace eez {
 namespace flow {
 
+struct SampleBatch;
+
 struct LineChartLine {
     AssetsPtr<uint8_t> label;
     uint16_t color;
@@ -36,6 +38,46 @@ struct Point {
     float lines[1];
 };
 
+// Sliding window min or max of one column of the ring buffer. Keeps the point
+// indexes whose values are still candidates, so the value at the front is the
+// min (max) of the window and every push/evict is amortized O(1).
+struct LineChartMonotonicDeque {
+    uint32_t *items;
+    uint32_t first;
+    uint32_t count;
+
+    void reset() {
+        first = 0;
+        count = 0;
+    }
+
+    template<typename T, bool IS_MIN>
+    void push(const T *column, uint32_t pointIndex, uint32_t capacity) {
+        T value = column[pointIndex];
+        while (count > 0) {
+            T back = column[items[(first + count - 1) % capacity]];
+            if (IS_MIN ? back < value : back > value) {
+                break;
+            }
+            count--;
+        }
+        items[(first + count) % capacity] = pointIndex;
+        count++;
+    }
+
+    // called with the index of the oldest point just before it is overwritten
+    void evict(uint32_t pointIndex, uint32_t capacity) {
+        if (count > 0 && items[first] == pointIndex) {
+            first = (first + 1) % capacity;
+            count--;
+        }
+    }
+
+    uint32_t front() const {
+        return items[first];
+    }
+};
+
 struct LineChartWidgetComponenentExecutionState : public ComponenentExecutionState {
     LineChartWidgetComponenentExecutionState();
     ~LineChartWidgetComponenentExecutionState();
@@ -53,22 +95,51 @@ struct LineChartWidgetComponenentExecutionState : public ComponenentExecutionSta
 
     bool onInputValue(FlowState *flowState, unsigned componentIndex);
 
-    Value getX(int pointIndex);
-    void setX(int pointIndex, Value& value);
+    void reset();
+
+    // y points to numLines values
+    void appendPoint(double x, bool xIsDate, const float *y);
+
+    // y is row major, count x numLines values; only the last maxPoints points are stored
+    void appendPoints(const double *x, bool xIsDate, const float *y, uint32_t count);
+
+    // samples are x followed by numLines values (see SampleBatch)
+    bool appendSampleBatch(const SampleBatch *sampleBatch);
 
-    float getY(int pointIndex, int lineIndex);
-    void setY(int pointIndex, int lineIndex, float value);
+    double getX(int pointIndex) {
+        return xValues[pointIndex];
+    }
+
+    bool isXDate(int pointIndex) {
+        return xIsDate[pointIndex] != 0;
+    }
+
+    float getY(int pointIndex, int lineIndex) {
+        return yValues[lineIndex * maxPoints + pointIndex];
+    }
+
+    // O(1) bounds of the points currently in the buffer, NaN y values are ignored
+    bool getXRange(double &min, double &max);
+    bool getYRange(double &min, double &max);
 
 private:
-    // Data structure where n is no. of points, m is no. of lines, Xi is Value and Yij is float:
-    // X1
-    // X2
-    // Xn
-    // Y11 Y12 ... Y1m
-    // Y21 Y22 ... Y2m
+    // Columns of the ring buffer where n is maxPoints and m is no. of lines:
+    // X1 ... Xn (double)
+    // Y11 ... Y1n (float, line 1)
     // ...
-    // Yn1 Yn2 ... Ynm,
+    // Ym1 ... Ymn (float, line m)
+    // Y1 ... Ym (float, values of the point being evaluated)
+    // D1 ... Dn (uint8_t, X is date)
+    // followed by the items of the min and max deques for X and for every line
     void *data;
+
+    double *xValues;
+    float *yValues;
+    float *evalYValues;
+    uint8_t *xIsDate;
+
+    // [0] X min, [1] X max, [2 + 2 * i] line i min, [3 + 2 * i] line i max
+    LineChartMonotonicDeque *deques;
 };
 
 #endif // EEZ_OPTION_GUI
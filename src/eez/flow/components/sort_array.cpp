@@ -13,6 +13,7 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include <eez/core/alloc.h>
 #include <eez/core/util.h>
 #include <eez/core/debug.h>
 #include <eez/core/utf8.h>
@@ -27,66 +28,296 @@
 namespace eez {
 namespace flow {
 
-SortArrayActionComponent *g_sortArrayActionComponent;
+// Sort keys are extracted once from the array elements, then an array of
+// (key, original index) pairs is sorted and the elements are permuted.
+struct SortKey {
+    union {
+        int64_t int64Value;
+        double doubleValue;
+        const char *stringValue;
+    };
+    uint32_t index;
+    bool valid;
+};
 
-int elementCompare(const void *a, const void *b) {
-    auto aValue = *(const Value *)a;
-    auto bValue = *(const Value *)b;
+struct Int64KeyCompare {
+    int operator()(const SortKey &a, const SortKey &b) const {
+        return a.int64Value < b.int64Value ? -1 : a.int64Value > b.int64Value ? 1 : 0;
+    }
+};
+
+struct DoubleKeyCompare {
+    int operator()(const SortKey &a, const SortKey &b) const {
+        return a.doubleValue < b.doubleValue ? -1 : a.doubleValue > b.doubleValue ? 1 : 0;
+    }
+};
+
+struct StringKeyCompare {
+    int operator()(const SortKey &a, const SortKey &b) const {
+        return utf8cmp(a.stringValue, b.stringValue);
+    }
+};
 
-    if (g_sortArrayActionComponent->arrayType != -1) {
-        if (!aValue.isArray()) {
-            return 0;
+struct StringIgnoreCaseKeyCompare {
+    int operator()(const SortKey &a, const SortKey &b) const {
+        return utf8casecmp(a.stringValue, b.stringValue);
+    }
+};
+
+// Elements without a valid key (missing struct field, not a number) are put
+// at the end. Equal keys are ordered by original index if stable sort is requested.
+template <typename KeyCompare>
+struct SortKeyLess {
+    KeyCompare keyCompare;
+    bool descending;
+    bool stable;
+
+    bool operator()(const SortKey &a, const SortKey &b) const {
+        if (a.valid != b.valid) {
+            return a.valid;
+        }
+        if (a.valid) {
+            int result = keyCompare(a, b);
+            if (result != 0) {
+                return descending ? result > 0 : result < 0;
+            }
         }
-        auto aArray = aValue.getArray();
-        if ((uint32_t)g_sortArrayActionComponent->structFieldIndex >= aArray->arraySize) {
-            return 0;
+        return stable && a.index < b.index;
+    }
+};
+
+static inline void swapKeys(SortKey &a, SortKey &b) {
+    SortKey temp = a;
+    a = b;
+    b = temp;
+}
+
+template <typename Less>
+static void insertionSort(SortKey *first, SortKey *last, const Less &less) {
+    for (SortKey *i = first + 1; i < last; i++) {
+        SortKey key = *i;
+        SortKey *j = i;
+        for (; j > first && less(key, *(j - 1)); j--) {
+            *j = *(j - 1);
         }
-        aValue = aArray->values[g_sortArrayActionComponent->structFieldIndex];
+        *j = key;
+    }
+}
 
-        if (!bValue.isArray()) {
-            return 0;
+template <typename Less>
+static void siftDown(SortKey *keys, size_t i, size_t n, const Less &less) {
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= n) {
+            break;
+        }
+        if (child + 1 < n && less(keys[child], keys[child + 1])) {
+            child++;
         }
-        auto bArray = bValue.getArray();
-        if ((uint32_t)g_sortArrayActionComponent->structFieldIndex >= bArray->arraySize) {
-            return 0;
+        if (!less(keys[i], keys[child])) {
+            break;
         }
-        bValue = bArray->values[g_sortArrayActionComponent->structFieldIndex];
+        swapKeys(keys[i], keys[child]);
+        i = child;
     }
+}
 
-    int result;
+template <typename Less>
+static void heapSort(SortKey *keys, size_t n, const Less &less) {
+    for (size_t i = n / 2; i > 0; i--) {
+        siftDown(keys, i - 1, n, less);
+    }
+    for (size_t i = n - 1; i > 0; i--) {
+        swapKeys(keys[0], keys[i]);
+        siftDown(keys, 0, i, less);
+    }
+}
 
-    if (aValue.isString() && bValue.isString()) {
-        if (g_sortArrayActionComponent->flags & SORT_ARRAY_FLAG_IGNORE_CASE) {
-            result = utf8casecmp(aValue.getString(), bValue.getString());
-        } else {
-            result = utf8cmp(aValue.getString(), bValue.getString());
+// introsort: quicksort with median of three pivot, heapsort if recursion gets
+// too deep and insertion sort for small partitions
+template <typename Less>
+static void introSort(SortKey *first, SortKey *last, int depthLimit, const Less &less) {
+    static const int INSERTION_SORT_THRESHOLD = 16;
+
+    while (last - first > INSERTION_SORT_THRESHOLD) {
+        if (depthLimit == 0) {
+            heapSort(first, last - first, less);
+            return;
         }
-    } else {
-        int err;
-        float aDouble = aValue.toDouble(&err);
-        if (err) {
-            return 0;
+        depthLimit--;
+
+        SortKey *mid = first + (last - first) / 2;
+        if (less(*mid, *first)) swapKeys(*mid, *first);
+        if (less(*(last - 1), *mid)) {
+            swapKeys(*(last - 1), *mid);
+            if (less(*mid, *first)) swapKeys(*mid, *first);
         }
-        float bDouble = bValue.toDouble(&err);
-        if (err) {
-            return 0;
+
+        SortKey pivot = *mid;
+        SortKey *i = first - 1;
+        SortKey *j = last;
+        for (;;) {
+            do { i++; } while (less(*i, pivot));
+            do { j--; } while (less(pivot, *j));
+            if (i >= j) {
+                break;
+            }
+            swapKeys(*i, *j);
         }
 
-        auto diff = aDouble - bDouble;
-        result = diff < 0 ? -1 : diff > 0 ? 1 : 0;
+        // [first, j] and [j + 1, last), recurse into the smaller one
+        if (j + 1 - first < last - (j + 1)) {
+            introSort(first, j + 1, depthLimit, less);
+            first = j + 1;
+        } else {
+            introSort(j + 1, last, depthLimit, less);
+            last = j + 1;
+        }
+    }
+
+    insertionSort(first, last, less);
+}
+
+template <typename KeyCompare>
+static void sortKeys(SortKey *keys, uint32_t n, bool descending, bool stable) {
+    SortKeyLess<KeyCompare> less;
+    less.descending = descending;
+    less.stable = stable;
+
+    int depthLimit = 0;
+    for (uint32_t i = n; i > 1; i >>= 1) {
+        depthLimit += 2;
     }
 
-    if (!(g_sortArrayActionComponent->flags & SORT_ARRAY_FLAG_ASCENDING)) {
-        result = -result;
+    introSort(keys, keys + n, depthLimit, less);
+}
+
+static const Value *getSortValue(SortArrayActionComponent *component, const Value &element) {
+    if (component->arrayType == -1) {
+        return &element;
     }
+    if (!element.isArray()) {
+        return nullptr;
+    }
+    auto elementArray = element.getArray();
+    if ((uint32_t)component->structFieldIndex >= elementArray->arraySize) {
+        return nullptr;
+    }
+    return &elementArray->values[component->structFieldIndex];
+}
 
-    return result;
+// null and undefined keys are not valid, these elements go to the end
+// and don't affect how the other keys are compared
+static inline bool isMissingSortValue(const Value *value) {
+    return !value || value->getType() == VALUE_TYPE_UNDEFINED || value->getType() == VALUE_TYPE_NULL;
 }
 
-void sortArray(SortArrayActionComponent *component, ArrayValue *array) {
-    g_sortArrayActionComponent = component;
-    qsort(&array->values[0], array->arraySize, sizeof(Value), elementCompare);
+enum SortKeyType {
+    SORT_KEY_TYPE_INT64,
+    SORT_KEY_TYPE_DOUBLE,
+    SORT_KEY_TYPE_STRING
+};
+
+bool sortArray(SortArrayActionComponent *component, ArrayValue *array) {
+    uint32_t n = array->arraySize;
+    if (n < 2) {
+        return true;
+    }
+
+    // strings are compared as strings only if all valid keys are strings,
+    // integers are compared exactly only if all valid keys are integers
+    bool allStrings = true;
+    bool allIntegers = true;
+    for (uint32_t i = 0; i < n && (allStrings || allIntegers); i++) {
+        auto value = getSortValue(component, array->values[i]);
+        if (!isMissingSortValue(value)) {
+            if (!value->isString()) {
+                allStrings = false;
+            }
+            if (!value->isInt32OrLess() && !value->isInt64()) {
+                allIntegers = false;
+            }
+        }
+    }
+    SortKeyType keyType = allStrings ? SORT_KEY_TYPE_STRING : allIntegers ? SORT_KEY_TYPE_INT64 : SORT_KEY_TYPE_DOUBLE;
+
+    static const uint32_t MAX_KEYS_ON_STACK = 32;
+    SortKey keysOnStack[MAX_KEYS_ON_STACK];
+    SortKey *keys = keysOnStack;
+    if (n > MAX_KEYS_ON_STACK) {
+        keys = (SortKey *)alloc(n * sizeof(SortKey), 0x50a7b3e1);
+        if (!keys) {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        auto &key = keys[i];
+        key.index = i;
+        key.valid = false;
+
+        auto value = getSortValue(component, array->values[i]);
+        if (isMissingSortValue(value)) {
+            continue;
+        }
+
+        if (keyType == SORT_KEY_TYPE_STRING) {
+            key.stringValue = value->getString();
+            key.valid = key.stringValue != nullptr;
+        } else if (keyType == SORT_KEY_TYPE_INT64) {
+            int err;
+            key.int64Value = value->toInt64(&err);
+            key.valid = !err;
+        } else {
+            int err;
+            key.doubleValue = value->toDouble(&err);
+            key.valid = !err && !isNaN(key.doubleValue);
+        }
+    }
 
+    bool descending = !(component->flags & SORT_ARRAY_FLAG_ASCENDING);
+    bool stable = (component->flags & SORT_ARRAY_FLAG_STABLE) != 0;
+
+    if (keyType == SORT_KEY_TYPE_STRING) {
+        if (component->flags & SORT_ARRAY_FLAG_IGNORE_CASE) {
+            sortKeys<StringIgnoreCaseKeyCompare>(keys, n, descending, stable);
+        } else {
+            sortKeys<StringKeyCompare>(keys, n, descending, stable);
+        }
+    } else if (keyType == SORT_KEY_TYPE_INT64) {
+        sortKeys<Int64KeyCompare>(keys, n, descending, stable);
+    } else {
+        sortKeys<DoubleKeyCompare>(keys, n, descending, stable);
+    }
+
+    // apply the permutation in place by following its cycles, values are
+    // moved as raw bytes so no reference counts are touched
+    for (uint32_t i = 0; i < n; i++) {
+        if (keys[i].index == i) {
+            continue;
+        }
+
+        alignas(Value) uint8_t temp[sizeof(Value)];
+        memcpy(temp, (void *)&array->values[i], sizeof(Value));
+
+        uint32_t j = i;
+        for (;;) {
+            uint32_t k = keys[j].index;
+            keys[j].index = j;
+            if (k == i) {
+                memcpy((void *)&array->values[j], temp, sizeof(Value));
+                break;
+            }
+            memcpy((void *)&array->values[j], (void *)&array->values[k], sizeof(Value));
+            j = k;
+        }
+    }
+
+    if (keys != keysOnStack) {
+        free(keys);
+    }
+
+    return true;
 }
 
 void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex) {
@@ -113,6 +344,7 @@ void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex) {
 
         if (component->structFieldIndex < 0) {
             throwError(flowState, componentIndex, "SortArray: invalid struct field index\n");
+            return;
         }
     } else {
         if (array->arrayType != defs_v3::ARRAY_TYPE_INTEGER && array->arrayType != defs_v3::ARRAY_TYPE_FLOAT && array->arrayType != defs_v3::ARRAY_TYPE_DOUBLE && array->arrayType != defs_v3::ARRAY_TYPE_STRING) {
@@ -121,7 +353,10 @@ void executeSortArrayComponent(FlowState *flowState, unsigned componentIndex) {
         }
     }
 
-    sortArray(component, array);
+    if (!sortArray(component, array)) {
+        throwError(flowState, componentIndex, "SortArray: out of memory\n");
+        return;
+    }
 
 	propagateValue(flowState, componentIndex, component->outputs.count - 1, arrayValue);
 }
@@ -17,6 +17,7 @@ namespace flow {
 
 #define SORT_ARRAY_FLAG_ASCENDING   (1 << 0)
 #define SORT_ARRAY_FLAG_IGNORE_CASE (1 << 1)
+#define SORT_ARRAY_FLAG_STABLE      (1 << 2)
 
 struct SortArrayActionComponent : public Component {
     int32_t arrayType;
@@ -24,7 +25,8 @@ struct SortArrayActionComponent : public Component {
     uint32_t flags;
 };
 
-void sortArray(SortArrayActionComponent *component, ArrayValue *array);
+// returns false if there is not enough memory for the sort keys
+bool sortArray(SortArrayActionComponent *component, ArrayValue *array);
 
 } // namespace flow
 } // namespace eez
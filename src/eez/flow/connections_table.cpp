@@ -0,0 +1,122 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <eez/conf-internal.h>
+
+#include <eez/flow/connections_table.h>
+
+namespace eez {
+namespace flow {
+
+static FlowDefinition *g_connectionsTablesFlowDefinition;
+static ConnectionsTable **g_connectionsTables;
+
+static ConnectionsTable *buildConnectionsTable(Flow *flow) {
+    uint32_t numComponents = flow->components.count;
+
+    uint32_t numOutputs = 0;
+    uint32_t numConnections = 0;
+    for (uint32_t componentIndex = 0; componentIndex < numComponents; componentIndex++) {
+        auto component = flow->components[componentIndex];
+        numOutputs += component->outputs.count;
+        for (uint32_t outputIndex = 0; outputIndex < component->outputs.count; outputIndex++) {
+            numConnections += component->outputs[outputIndex]->connections.count;
+        }
+    }
+
+    auto table = (ConnectionsTable *)alloc(
+        sizeof(ConnectionsTable) +
+        numConnections * sizeof(Connection) +
+        numComponents * sizeof(uint32_t) +
+        (numOutputs + 1) * sizeof(uint32_t) +
+        numComponents * sizeof(int16_t),
+        0x3e5a1c27
+    );
+    if (!table) {
+        return nullptr;
+    }
+
+    table->connections = (Connection *)(table + 1);
+    table->componentOutputsStart = (uint32_t *)(table->connections + numConnections);
+    table->outputConnectionsStart = table->componentOutputsStart + numComponents;
+    table->seqoutIndexes = (int16_t *)(table->outputConnectionsStart + numOutputs + 1);
+
+    uint32_t tableOutputIndex = 0;
+    uint32_t tableConnectionIndex = 0;
+    for (uint32_t componentIndex = 0; componentIndex < numComponents; componentIndex++) {
+        auto component = flow->components[componentIndex];
+
+        table->componentOutputsStart[componentIndex] = tableOutputIndex;
+        table->seqoutIndexes[componentIndex] = -1;
+
+        for (uint32_t outputIndex = 0; outputIndex < component->outputs.count; outputIndex++) {
+            auto componentOutput = component->outputs[outputIndex];
+
+            if (componentOutput->isSeqOut && table->seqoutIndexes[componentIndex] == -1) {
+                table->seqoutIndexes[componentIndex] = (int16_t)outputIndex;
+            }
+
+            table->outputConnectionsStart[tableOutputIndex++] = tableConnectionIndex;
+
+            for (uint32_t connectionIndex = 0; connectionIndex < componentOutput->connections.count; connectionIndex++) {
+                table->connections[tableConnectionIndex++] = *componentOutput->connections[connectionIndex];
+            }
+        }
+    }
+
+    table->outputConnectionsStart[tableOutputIndex] = tableConnectionIndex;
+
+    return table;
+}
+
+void buildConnectionsTables(Assets *assets) {
+    freeConnectionsTables();
+
+    auto flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
+    auto numFlows = flowDefinition->flows.count;
+
+    g_connectionsTables = (ConnectionsTable **)alloc(numFlows * sizeof(ConnectionsTable *), 0x9d0c4b51);
+    if (!g_connectionsTables) {
+        return;
+    }
+
+    g_connectionsTablesFlowDefinition = flowDefinition;
+
+    for (uint32_t flowIndex = 0; flowIndex < numFlows; flowIndex++) {
+        g_connectionsTables[flowIndex] = buildConnectionsTable(flowDefinition->flows[flowIndex]);
+    }
+}
+
+void freeConnectionsTables() {
+    if (g_connectionsTables) {
+        auto numFlows = g_connectionsTablesFlowDefinition ? g_connectionsTablesFlowDefinition->flows.count : 0;
+        for (uint32_t flowIndex = 0; flowIndex < numFlows; flowIndex++) {
+            if (g_connectionsTables[flowIndex]) {
+                free(g_connectionsTables[flowIndex]);
+            }
+        }
+        free(g_connectionsTables);
+        g_connectionsTables = nullptr;
+    }
+    g_connectionsTablesFlowDefinition = nullptr;
+}
+
+ConnectionsTable *getConnectionsTable(FlowDefinition *flowDefinition, unsigned flowIndex) {
+    // tables are built only for the flow definition passed to flow::start,
+    // for any other (e.g. external assets) old path through the assets is used
+    if (flowDefinition != g_connectionsTablesFlowDefinition) {
+        return nullptr;
+    }
+    return g_connectionsTables[flowIndex];
+}
+
+} // namespace flow
+} // namespace eez
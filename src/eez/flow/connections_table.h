@@ -0,0 +1,33 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <eez/flow/private.h>
+
+namespace eez {
+namespace flow {
+
+// Flattened copy of the component outputs and connections of one flow,
+// so propagateValue doesn't have to chase AssetsPtr offsets for every connection.
+struct ConnectionsTable {
+    int16_t *seqoutIndexes; // for each component, index of the @seqout output or -1
+    uint32_t *componentOutputsStart; // for each component, index of its first output in outputConnectionsStart
+    uint32_t *outputConnectionsStart; // for each output (plus one at the end), index of its first connection in connections
+    Connection *connections;
+};
+
+void buildConnectionsTables(Assets *assets);
+void freeConnectionsTables();
+ConnectionsTable *getConnectionsTable(FlowDefinition *flowDefinition, unsigned flowIndex);
+
+} // flow
+} // eez
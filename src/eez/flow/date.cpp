@@ -11,6 +11,7 @@
 #include <eez/conf-internal.h>
 
 #include <stdio.h>
+#include <string.h>
 
 #include <eez/core/os.h>
 
@@ -71,6 +72,9 @@ static void convertTime24to12(int &hours, bool &am);
 static bool isDst(Date time, DstRule dstRule);
 static uint8_t dayOfWeek(int y, int m, int d);
 static Date timeChangeRuleToLocal(TimeChangeRule &r, int year);
+static void breakDays(uint32_t daysSince1970, int &year, int &month, int &day);
+static char *formatNumber(char *p, int value, int minDigits);
+static void copyFormatted(char *str, uint32_t strLen, const char *formatted, char *end);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -78,28 +82,65 @@ Date now() {
     return utcToLocal(getDateNowHook());
 }
 
+// Same output as snprintf with "%04d-%02d-%02dT%02d:%02d:%02d.%06d".
 void toString(Date time, char *str, uint32_t strLen) {
     int year, month, day, hours, minutes, seconds, milliseconds;
     breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    snprintf(str, strLen, "%04d-%02d-%02dT%02d:%02d:%02d.%06d", year, month, day, hours, minutes, seconds, milliseconds);
+
+    char formatted[64];
+    char *p = formatted;
+    p = formatNumber(p, year, 4);
+    *p++ = '-';
+    p = formatNumber(p, month, 2);
+    *p++ = '-';
+    p = formatNumber(p, day, 2);
+    *p++ = 'T';
+    p = formatNumber(p, hours, 2);
+    *p++ = ':';
+    p = formatNumber(p, minutes, 2);
+    *p++ = ':';
+    p = formatNumber(p, seconds, 2);
+    *p++ = '.';
+    p = formatNumber(p, milliseconds, 6);
+
+    copyFormatted(str, strLen, formatted, p);
 }
 
+// Same output as snprintf with "%02d-%02d-%02d %02d:%02d:%02d.%03d[ AM|PM]".
 void toLocaleString(Date time, char *str, uint32_t strLen) {
     int year, month, day, hours, minutes, seconds, milliseconds;
     breakDate(time, year, month, day, hours, minutes, seconds, milliseconds);
-    if (g_localeFormat == FORMAT_DMY_24) {
-        snprintf(str, strLen, "%02d-%02d-%02d %02d:%02d:%02d.%03d", day, month, year, hours, minutes, seconds, milliseconds);
-    } else if (g_localeFormat == FORMAT_MDY_24) {
-        snprintf(str, strLen, "%02d-%02d-%02d %02d:%02d:%02d.%03d", month, day, year, hours, minutes, seconds, milliseconds);
-    } else if (g_localeFormat == FORMAT_DMY_12) {
-        bool am;
-        convertTime24to12(hours, am);
-        snprintf(str, strLen, "%02d-%02d-%02d %02d:%02d:%02d.%03d %s", day, month, year, hours, minutes, seconds, milliseconds, am ? "AM" : "PM");
-    } else if (g_localeFormat == FORMAT_MDY_12) {
-        bool am;
+
+    bool is12 = g_localeFormat == FORMAT_DMY_12 || g_localeFormat == FORMAT_MDY_12;
+    bool am = false;
+    if (is12) {
         convertTime24to12(hours, am);
-        snprintf(str, strLen, "%02d-%02d-%02d %02d:%02d:%02d.%03d %s", month, day, year, hours, minutes, seconds, milliseconds, am ? "AM" : "PM");
     }
+
+    bool isMDY = g_localeFormat == FORMAT_MDY_24 || g_localeFormat == FORMAT_MDY_12;
+
+    char formatted[64];
+    char *p = formatted;
+    p = formatNumber(p, isMDY ? month : day, 2);
+    *p++ = '-';
+    p = formatNumber(p, isMDY ? day : month, 2);
+    *p++ = '-';
+    p = formatNumber(p, year, 2);
+    *p++ = ' ';
+    p = formatNumber(p, hours, 2);
+    *p++ = ':';
+    p = formatNumber(p, minutes, 2);
+    *p++ = ':';
+    p = formatNumber(p, seconds, 2);
+    *p++ = '.';
+    p = formatNumber(p, milliseconds, 3);
+    if (is12) {
+        *p++ = ' ';
+        *p++ = am ? 'A' : 'P';
+        *p++ = 'M';
+    }
+
+    copyFormatted(str, strLen, formatted, p);
 }
 
 Date fromString(const char *str) {
@@ -142,10 +183,6 @@ Date makeDate(int year, int month, int day, int hours, int minutes, int seconds,
 
 void breakDate(Date time, int &result_year, int &result_month, int &result_day, int &result_hours, int &result_minutes, int &result_seconds, int &result_milliseconds) {
     // break the given time_t into time components
-    uint8_t year;
-    uint8_t month, monthLength;
-    uint32_t days;
-
     result_milliseconds = time % 1000;
     time /= 1000; // now it is seconds
 
@@ -158,6 +195,38 @@ void breakDate(Date time, int &result_year, int &result_month, int &result_day,
     result_hours = time % 24;
     time /= 24; // now it is days
 
+    breakDays((uint32_t)time, result_year, result_month, result_day);
+}
+
+// Days recently broken into year, month and day, so the getters, formatting
+// and DST checks of the same date do the calendar math once.
+static const int BROKEN_DAYS_CACHE_SIZE = 4;
+
+static struct {
+    uint32_t daysSince1970;
+    int year; // 0 if not used
+    int month;
+    int day;
+} g_brokenDaysCache[BROKEN_DAYS_CACHE_SIZE];
+
+static int g_brokenDaysCacheNext;
+
+static void breakDays(uint32_t daysSince1970, int &result_year, int &result_month, int &result_day) {
+    for (int i = 0; i < BROKEN_DAYS_CACHE_SIZE; i++) {
+        auto &entry = g_brokenDaysCache[i];
+        if (entry.year != 0 && entry.daysSince1970 == daysSince1970) {
+            result_year = entry.year;
+            result_month = entry.month;
+            result_day = entry.day;
+            return;
+        }
+    }
+
+    uint8_t year;
+    uint8_t month, monthLength;
+    uint32_t days;
+    uint32_t time = daysSince1970;
+
     year = 0;
     days = 0;
     while ((unsigned)(days += (LEAP_YEAR(year) ? 366 : 365)) <= time) {
@@ -191,6 +260,45 @@ void breakDate(Date time, int &result_year, int &result_month, int &result_day,
 
     result_month = month + 1; // jan is month 1
     result_day = time + 1;    // day of month
+
+    auto &entry = g_brokenDaysCache[g_brokenDaysCacheNext];
+    g_brokenDaysCacheNext = (g_brokenDaysCacheNext + 1) % BROKEN_DAYS_CACHE_SIZE;
+    entry.daysSince1970 = daysSince1970;
+    entry.year = result_year;
+    entry.month = result_month;
+    entry.day = result_day;
+}
+
+// Writes non negative value with at least minDigits digits, like "%0*d".
+static char *formatNumber(char *p, int value, int minDigits) {
+    char digits[10];
+    int numDigits = 0;
+    do {
+        digits[numDigits++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    for (int i = numDigits; i < minDigits; i++) {
+        *p++ = '0';
+    }
+    while (numDigits > 0) {
+        *p++ = digits[--numDigits];
+    }
+
+    return p;
+}
+
+// Copies formatted text truncated to strLen, like snprintf.
+static void copyFormatted(char *str, uint32_t strLen, const char *formatted, char *end) {
+    if (strLen == 0) {
+        return;
+    }
+    uint32_t len = end - formatted;
+    if (len > strLen - 1) {
+        len = strLen - 1;
+    }
+    memcpy(str, formatted, len);
+    str[len] = 0;
 }
 
 int getYear(Date time) {
@@ -282,6 +390,14 @@ static void convertTime24to12(int &hours, bool &am) {
 //    }
 //}
 
+// DST transitions of the last two years (around new year both are needed)
+static struct {
+    DstRule dstRule; // DST_RULE_OFF if not used
+    int year;
+    Date dstStart;
+    Date dstEnd;
+} g_dstTransitionsCache[2];
+
 static bool isDst(Date local, DstRule dstRule) {
     if (dstRule == DST_RULE_OFF) {
         return false;
@@ -290,8 +406,16 @@ static bool isDst(Date local, DstRule dstRule) {
     int year, month, day, hours, minutes, seconds, milliseconds;
     breakDate(local, year, month, day, hours, minutes, seconds, milliseconds);
 
-    Date dstStart = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstStart, year);
-    Date dstEnd = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstEnd, year);
+    auto &transitions = g_dstTransitionsCache[year % 2];
+    if (transitions.dstRule != dstRule || transitions.year != year) {
+        transitions.dstRule = dstRule;
+        transitions.year = year;
+        transitions.dstStart = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstStart, year);
+        transitions.dstEnd = timeChangeRuleToLocal(g_dstRules[dstRule - 1].dstEnd, year);
+    }
+
+    Date dstStart = transitions.dstStart;
+    Date dstEnd = transitions.dstEnd;
 
     return (dstStart < dstEnd && (local >= dstStart && local < dstEnd)) ||
            (dstStart > dstEnd && (local >= dstStart || local < dstEnd));
@@ -320,9 +444,10 @@ static Date timeChangeRuleToLocal(TimeChangeRule &r, int year) {
 
     uint8_t dow = dayOfWeek(year, month, 1);
 
-    time += (7 * (week - 1) + (r.dow - dow + 7) % 7) * SECONDS_PER_DAY;
+    // makeDate returns milliseconds
+    time += (7 * (week - 1) + (r.dow - dow + 7) % 7) * SECONDS_PER_DAY * 1000;
     if (r.week == 0) {
-        time -= 7 * SECONDS_PER_DAY; // back up a week if this is a "Last" rule
+        time -= 7 * SECONDS_PER_DAY * 1000; // back up a week if this is a "Last" rule
     }
 
     return time;
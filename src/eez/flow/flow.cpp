@@ -24,6 +24,8 @@
 #include <eez/flow/hooks.h>
 #include <eez/flow/components/lvgl_user_widget.h>
 #include <eez/flow/watch_list.h>
+#include <eez/flow/sample_batch.h>
+#include <eez/flow/connections_table.h>
 
 #if EEZ_OPTION_GUI
 #include <eez/gui/gui.h>
@@ -67,6 +69,7 @@ unsigned start(Assets *assets) {
     g_isStopping = false;
 
     initGlobalVariables(assets);
+    buildConnectionsTables(assets);
 
 	queueReset();
     watchListReset();
@@ -90,6 +93,8 @@ void tick() {
 
 	uint32_t startTickCount = millis();
 
+    propagateSampleBatches();
+
     auto n = getQueueSize();
 
     for (size_t i = 0; i < n || g_numContinuousTaskInQueue > 0; i++) {
@@ -157,10 +162,14 @@ void doStop() {
     finishToDebuggerMessageHook();
     g_debuggerIsConnected = false;
 
+    sampleBatchPropagatorsReset();
+
     freeAllChildrenFlowStates(g_firstFlowState);
     g_firstFlowState = nullptr;
     g_lastFlowState = nullptr;
 
+    freeConnectionsTables();
+
     g_isStopped = true;
 
 	queueReset();
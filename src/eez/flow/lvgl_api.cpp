@@ -35,6 +35,7 @@
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/components/lvgl_user_widget.h>
 #include <eez/flow/lvgl_api.h>
+#include <eez/flow/sample_batch.h>
 
 static void replacePageHook(int16_t pageId, uint32_t animType, uint32_t speed, uint32_t delay);
 
@@ -163,6 +164,18 @@ extern "C" void flowPropagateValueUint32(void *flowState, unsigned componentInde
     eez::flow::propagateValue((eez::flow::FlowState *)flowState, componentIndex, outputIndex, eez::Value(value, eez::VALUE_TYPE_UINT32));
 }
 
+extern "C" void *flowCreateSampleBatchPropagator(void *flowState, unsigned componentIndex, unsigned outputIndex, unsigned numValuesPerSample, unsigned capacity) {
+    return eez::flow::createSampleBatchPropagator((eez::flow::FlowState *)flowState, componentIndex, outputIndex, numValuesPerSample, capacity);
+}
+
+extern "C" void flowDestroySampleBatchPropagator(void *propagator) {
+    eez::flow::destroySampleBatchPropagator((eez::flow::SampleBatchPropagator *)propagator);
+}
+
+extern "C" unsigned flowPushSamples(void *propagator, const double *values, unsigned numSamples) {
+    return eez::flow::pushSamples((eez::flow::SampleBatchPropagator *)propagator, values, numSamples);
+}
+
 #ifndef EEZ_LVGL_TEMP_STRING_BUFFER_SIZE
 #define EEZ_LVGL_TEMP_STRING_BUFFER_SIZE 1024
 #endif
@@ -174,6 +187,13 @@ extern "C" const char *evalTextProperty(void *flowState, unsigned componentIndex
     if (!eez::flow::evalProperty((eez::flow::FlowState *)flowState, componentIndex, propertyIndex, value, errorMessage)) {
         return "";
     }
+    if (value.getType() == eez::VALUE_TYPE_STRING_ASSET) {
+        // string is in the assets, no need to copy it
+        const char *str = value.getString();
+        return str ? str : "";
+    }
+    // everything else, including strings from native code which can be
+    // changed or freed by the time the caller uses the result, is copied
     value.toText(textValue, sizeof(textValue));
     return textValue;
 }
@@ -218,15 +238,13 @@ const char *evalStringArrayPropertyAndJoin(void *flowState, unsigned componentIn
         textValue[0] = 0;
         size_t textPosition = 0;
 
-        size_t separatorLength = strlen(separator);
-
         for (uint32_t elementIndex = 0; elementIndex < array->arraySize; elementIndex++) {
             if (elementIndex > 0) {
-                eez::stringAppendString(textValue + textPosition, sizeof(textValue) - textPosition, separator);
-                textPosition += separatorLength;
+                eez::stringCopy(textValue + textPosition, sizeof(textValue) - textPosition, separator);
+                textPosition += strlen(textValue + textPosition);
             }
             array->values[elementIndex].toText(textValue + textPosition, sizeof(textValue) - textPosition);
-            textPosition = strlen(textValue);
+            textPosition += strlen(textValue + textPosition);
         }
 
         return textValue;
@@ -235,6 +253,205 @@ const char *evalStringArrayPropertyAndJoin(void *flowState, unsigned componentIn
     return "";
 }
 
+namespace eez {
+namespace flow {
+
+void freeLVGLPropertyCache(FlowState *flowState) {
+    auto cache = flowState->lvglPropertyCache;
+    if (cache) {
+        for (uint32_t i = 0; i < cache->numValues; i++) {
+            (cache->values + i)->~Value();
+        }
+        free(cache);
+        flowState->lvglPropertyCache = nullptr;
+    }
+}
+
+static LVGLPropertyCache *getLVGLPropertyCache(FlowState *flowState) {
+    if (flowState->lvglPropertyCache) {
+        return flowState->lvglPropertyCache;
+    }
+
+    auto flow = flowState->flow;
+
+    uint32_t numValues = 0;
+    for (uint32_t i = 0; i < flow->components.count; i++) {
+        numValues += flow->components[i]->properties.count;
+    }
+
+    size_t headerSize = (sizeof(LVGLPropertyCache) + 7) & ~7;
+
+    auto cache = (LVGLPropertyCache *)alloc(
+        headerSize +
+        numValues * sizeof(Value) +
+        flow->components.count * sizeof(uint32_t) +
+        numValues * sizeof(bool),
+        0x7d2e91a4
+    );
+    if (!cache) {
+        return nullptr;
+    }
+
+    cache->values = (Value *)((uint8_t *)cache + headerSize);
+    cache->propertyOffsets = (uint32_t *)(cache->values + numValues);
+    cache->isValid = (bool *)(cache->propertyOffsets + flow->components.count);
+    cache->numValues = numValues;
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < flow->components.count; i++) {
+        cache->propertyOffsets[i] = offset;
+        offset += flow->components[i]->properties.count;
+    }
+
+    for (uint32_t i = 0; i < numValues; i++) {
+        new (cache->values + i) Value();
+        cache->isValid[i] = false;
+    }
+
+    flowState->lvglPropertyCache = cache;
+
+    return cache;
+}
+
+// Only for these types equal values also give equal text, widget value, etc.
+static bool isLVGLPropertyCacheable(const Value &value) {
+    auto type = value.getType();
+    return
+        type == VALUE_TYPE_NULL ||
+        type == VALUE_TYPE_BOOLEAN ||
+        (type >= VALUE_TYPE_INT8 && type <= VALUE_TYPE_UINT64) ||
+        type == VALUE_TYPE_FLOAT ||
+        type == VALUE_TYPE_DOUBLE ||
+        value.isString();
+}
+
+enum EvalPropertyIfChangedResult {
+    EVAL_PROPERTY_ERROR,
+    EVAL_PROPERTY_NOT_CHANGED,
+    EVAL_PROPERTY_CHANGED
+};
+
+// Evaluates property and checks if it has the same value as in the previous call.
+// If changed, cachedValue points to the evaluated value kept in the cache
+// (or is nullptr if value can't be cached).
+static EvalPropertyIfChangedResult evalPropertyIfChanged(FlowState *flowState, unsigned componentIndex, unsigned propertyIndex, Value &value, Value *&cachedValue, const char *errorMessage) {
+    cachedValue = nullptr;
+
+    auto cache = getLVGLPropertyCache(flowState);
+    auto i = cache ? cache->propertyOffsets[componentIndex] + propertyIndex : 0;
+
+    if (!evalProperty(flowState, componentIndex, propertyIndex, value, errorMessage)) {
+        if (cache) {
+            cache->isValid[i] = false;
+        }
+        return EVAL_PROPERTY_ERROR;
+    }
+
+    if (!cache) {
+        return EVAL_PROPERTY_CHANGED;
+    }
+
+    if (!isLVGLPropertyCacheable(value)) {
+        cache->isValid[i] = false;
+        cache->values[i] = Value();
+        return EVAL_PROPERTY_CHANGED;
+    }
+
+    auto &previousValue = cache->values[i];
+    if (
+        cache->isValid[i] &&
+        (previousValue.getType() == value.getType() || (previousValue.isString() && value.isString())) &&
+        previousValue == value
+    ) {
+        return EVAL_PROPERTY_NOT_CHANGED;
+    }
+
+    if (value.getType() == VALUE_TYPE_STRING && value.getString()) {
+        // VALUE_TYPE_STRING points to a buffer owned by the native code, which can be
+        // changed in place or freed, so keep a copy of the string in the cache
+        cache->values[i] = Value::makeStringRef(value.getString(), -1, 0x3c8f1e27);
+    } else {
+        cache->values[i] = value;
+    }
+    cache->isValid[i] = true;
+    cachedValue = &cache->values[i];
+
+    return EVAL_PROPERTY_CHANGED;
+}
+
+} // flow
+} // eez
+
+extern "C" bool evalTextPropertyIfChanged(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char **result, const char *errorMessage) {
+    eez::Value value;
+    eez::Value *cachedValue;
+    auto evalResult = eez::flow::evalPropertyIfChanged((eez::flow::FlowState *)flowState, componentIndex, propertyIndex, value, cachedValue, errorMessage);
+    if (evalResult == eez::flow::EVAL_PROPERTY_NOT_CHANGED) {
+        return false;
+    }
+
+    if (evalResult == eez::flow::EVAL_PROPERTY_ERROR) {
+        *result = "";
+    } else if (cachedValue && cachedValue->isString()) {
+        // cached value keeps the string alive until the next call
+        const char *str = cachedValue->getString();
+        *result = str ? str : "";
+    } else {
+        value.toText(textValue, sizeof(textValue));
+        *result = textValue;
+    }
+
+    return true;
+}
+
+extern "C" bool evalIntegerPropertyIfChanged(void *flowState, unsigned componentIndex, unsigned propertyIndex, int32_t *result, const char *errorMessage) {
+    eez::Value value;
+    eez::Value *cachedValue;
+    auto evalResult = eez::flow::evalPropertyIfChanged((eez::flow::FlowState *)flowState, componentIndex, propertyIndex, value, cachedValue, errorMessage);
+    if (evalResult == eez::flow::EVAL_PROPERTY_NOT_CHANGED) {
+        return false;
+    }
+
+    if (evalResult == eez::flow::EVAL_PROPERTY_ERROR) {
+        *result = 0;
+        return true;
+    }
+
+    int err;
+    int32_t intValue = value.toInt32(&err);
+    if (err) {
+        eez::flow::throwError((eez::flow::FlowState *)flowState, componentIndex, errorMessage);
+        intValue = 0;
+    }
+    *result = intValue;
+
+    return true;
+}
+
+extern "C" bool evalBooleanPropertyIfChanged(void *flowState, unsigned componentIndex, unsigned propertyIndex, bool *result, const char *errorMessage) {
+    eez::Value value;
+    eez::Value *cachedValue;
+    auto evalResult = eez::flow::evalPropertyIfChanged((eez::flow::FlowState *)flowState, componentIndex, propertyIndex, value, cachedValue, errorMessage);
+    if (evalResult == eez::flow::EVAL_PROPERTY_NOT_CHANGED) {
+        return false;
+    }
+
+    if (evalResult == eez::flow::EVAL_PROPERTY_ERROR) {
+        *result = false;
+        return true;
+    }
+
+    int err;
+    bool booleanValue = value.toBool(&err);
+    if (err) {
+        eez::flow::throwError((eez::flow::FlowState *)flowState, componentIndex, errorMessage);
+        booleanValue = false;
+    }
+    *result = booleanValue;
+
+    return true;
+}
+
 extern "C" void assignStringProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *value, const char *errorMessage) {
     auto component = ((eez::flow::FlowState *)flowState)->flow->components[componentIndex];
 
@@ -64,11 +64,25 @@ void flowPropagateValue(void *flowState, unsigned componentIndex, unsigned outpu
 void flowPropagateValueInt32(void *flowState, unsigned componentIndex, unsigned outputIndex, int32_t value);
 void flowPropagateValueUint32(void *flowState, unsigned componentIndex, unsigned outputIndex, uint32_t value);
 
+// Batched propagation of samples (numValuesPerSample doubles each) for high rate data.
+// Create and destroy from the flow thread, push from any (but only one) thread.
+// Pending samples are propagated as one value on the next flow tick.
+void *flowCreateSampleBatchPropagator(void *flowState, unsigned componentIndex, unsigned outputIndex, unsigned numValuesPerSample, unsigned capacity);
+void flowDestroySampleBatchPropagator(void *propagator);
+unsigned flowPushSamples(void *propagator, const double *values, unsigned numSamples);
+
 const char *evalTextProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *errorMessage);
 int32_t evalIntegerProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *errorMessage);
 bool evalBooleanProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *errorMessage);
 const char *evalStringArrayPropertyAndJoin(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *errorMessage, const char *separator);
 
+// Same as eval*Property, but return false if the property value is the same as in the
+// previous call for this flow state, component and property. In that case the result
+// is not set and the widget doesn't have to be compared nor updated.
+bool evalTextPropertyIfChanged(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char **result, const char *errorMessage);
+bool evalIntegerPropertyIfChanged(void *flowState, unsigned componentIndex, unsigned propertyIndex, int32_t *result, const char *errorMessage);
+bool evalBooleanPropertyIfChanged(void *flowState, unsigned componentIndex, unsigned propertyIndex, bool *result, const char *errorMessage);
+
 void assignStringProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, const char *value, const char *errorMessage);
 void assignIntegerProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, int32_t value, const char *errorMessage);
 void assignBooleanProperty(void *flowState, unsigned componentIndex, unsigned propertyIndex, bool value, const char *errorMessage);
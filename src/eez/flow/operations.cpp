@@ -1787,7 +1787,7 @@ void do_OPERATION_TYPE_STRING_LENGTH(EvalStack &stack) {
         return;
     }
 
-    int aStrLen = strlen(aStr);
+    int aStrLen = a.getStringLength();
 
     stack.push(Value(aStrLen, VALUE_TYPE_INT32));
 }
@@ -1820,7 +1820,7 @@ void do_OPERATION_TYPE_STRING_SUBSTRING(EvalStack &stack) {
         return;
     }
 
-    int strLen = (int)strlen(str);
+    int strLen = strValue.getStringLength();
 
     int err = 0;
 
@@ -2104,7 +2104,7 @@ void do_OPERATION_TYPE_STRING_PAD_START(EvalStack &stack) {
         stack.push(Value::makeError());
         return;
     }
-    int strLen = strlen(str.getString());
+    int strLen = str.getStringLength();
 
     int err;
     int targetLength = b.toInt32(&err);
@@ -2121,7 +2121,7 @@ void do_OPERATION_TYPE_STRING_PAD_START(EvalStack &stack) {
         stack.push(Value::makeError());
         return;
     }
-    int padStrLen = strlen(padStr.getString());
+    int padStrLen = padStr.getStringLength();
 
     Value resultValue = Value::makeStringRef("", targetLength, 0xf43b14dd);
     if (resultValue.type == VALUE_TYPE_NULL) {
@@ -2164,35 +2164,12 @@ void do_OPERATION_TYPE_STRING_SPLIT(EvalStack &stack) {
         return;
     }
 
-    auto strLen = strlen(str);
-
-    char *strCopy = (char *)eez::alloc(strLen + 1, 0xea9d0bc0);
-    stringCopy(strCopy, strLen + 1, str);
-
-    // get num parts
-    size_t arraySize = 0;
-    char *token = strtok(strCopy, delim);
-    while (token != NULL) {
-        arraySize++;
-        token = strtok(NULL, delim);
-    }
-
-    eez::free(strCopy);
-    strCopy = (char *)eez::alloc(strLen + 1, 0xea9d0bc1);
-    stringCopy(strCopy, strLen + 1, str);
-
-    // make array
-    auto arrayValue = Value::makeArrayRef(arraySize, VALUE_TYPE_STRING, 0xe82675d4);
-    auto array = arrayValue.getArray();
-    int i = 0;
-    token = strtok(strCopy, delim);
-    while (token != NULL) {
-        array->values[i++] = Value::makeStringRef(token, -1, 0x45209ec0);
-        token = strtok(NULL, delim);
+    auto arrayValue = Value::splitString(str, strValue.getStringLength(), delim, 0xe82675d4);
+    if (arrayValue.type == VALUE_TYPE_NULL) {
+        stack.push(Value::makeError());
+        return;
     }
 
-    eez::free(strCopy);
-
     stack.push(arrayValue);
 }
 
@@ -2232,17 +2209,7 @@ void do_OPERATION_TYPE_STRING_CODE_POINT_AT(EvalStack &stack) {
         return;
     }
 
-    utf8_int32_t codePoint = 0;
-
-    const char *str = strValue.getString();
-    if (str) {
-        int index = indexValue.toInt32();
-        if (index >= 0) {
-            do {
-                str = utf8codepoint(str, &codePoint);
-            } while (codePoint && --index >= 0);
-        }
-    }
+    int32_t codePoint = strValue.getStringCodePointAt(indexValue.toInt32());
 
     stack.push(Value((int)codePoint, VALUE_TYPE_INT32));
 
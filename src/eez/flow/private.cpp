@@ -26,6 +26,7 @@ using namespace eez::gui;
 #include <eez/flow/debugger.h>
 #include <eez/flow/flow_defs_v3.h>
 #include <eez/flow/hooks.h>
+#include <eez/flow/connections_table.h>
 #include <eez/flow/components/call_action.h>
 #include <eez/flow/components/on_event.h>
 
@@ -39,6 +40,7 @@ namespace flow {
 GlobalVariables *g_globalVariables = nullptr;
 
 static const unsigned NO_COMPONENT_INDEX = 0xFFFFFFFF;
+static const uint16_t NO_INPUT_COMPONENT_INDEX = 0xFFFF;
 
 static bool g_enableThrowError = true;
 
@@ -106,31 +108,14 @@ bool isComponentReadyToRun(FlowState *flowState, unsigned componentIndex) {
 	// check if required inputs are defined:
 	//   - at least 1 seq input must be defined
 	//   - all non optional data inputs must be defined
-	int numSeqInputs = 0;
-	int numDefinedSeqInputs = 0;
-	for (unsigned inputIndex = 0; inputIndex < component->inputs.count; inputIndex++) {
-		auto inputValueIndex = component->inputs[inputIndex];
-
-		auto input = flowState->flow->componentInputs[inputValueIndex];
-
-		if (input & COMPONENT_INPUT_FLAG_IS_SEQ_INPUT) {
-			numSeqInputs++;
-			auto &value = flowState->values[inputValueIndex];
-			if (!isInputEmpty(value)) {
-				numDefinedSeqInputs++;
-			}
-		} else {
-			if (!(input & COMPONENT_INPUT_FLAG_IS_OPTIONAL)) {
-				auto &value = flowState->values[inputValueIndex];
-				if (isInputEmpty(value)) {
-					// non optional data input is undefined
-					return false;
-				}
-			}
-		}
+	auto &inputsState = flowState->componentInputsStates[componentIndex];
+
+	if (inputsState.numEmptyRequiredInputs > 0) {
+		// non optional data input is undefined
+		return false;
 	}
 
-	if (numSeqInputs && !numDefinedSeqInputs) {
+	if (inputsState.numSeqInputs && !inputsState.numDefinedSeqInputs) {
 		// no seq input is defined
 		return false;
 	}
@@ -138,6 +123,44 @@ bool isComponentReadyToRun(FlowState *flowState, unsigned componentIndex) {
 	return true;
 }
 
+static void onInputEmptyStateChanged(FlowState *flowState, unsigned inputIndex, bool isEmpty) {
+	auto componentIndex = flowState->inputComponentIndexes[inputIndex];
+	if (componentIndex == NO_INPUT_COMPONENT_INDEX) {
+		return;
+	}
+
+	auto &inputsState = flowState->componentInputsStates[componentIndex];
+
+	auto input = flowState->flow->componentInputs[inputIndex];
+	if (input & COMPONENT_INPUT_FLAG_IS_SEQ_INPUT) {
+		if (isEmpty) {
+			inputsState.numDefinedSeqInputs--;
+		} else {
+			inputsState.numDefinedSeqInputs++;
+		}
+	} else if (!(input & COMPONENT_INPUT_FLAG_IS_OPTIONAL)) {
+		if (isEmpty) {
+			inputsState.numEmptyRequiredInputs++;
+		} else {
+			inputsState.numEmptyRequiredInputs--;
+		}
+	}
+}
+
+static void setInputValue(FlowState *flowState, unsigned inputIndex, const Value &value) {
+	auto pValue = &flowState->values[inputIndex];
+
+	bool wasEmpty = isInputEmpty(*pValue);
+	*pValue = value;
+	bool isEmpty = isInputEmpty(*pValue);
+
+	if (wasEmpty != isEmpty) {
+		onInputEmptyStateChanged(flowState, inputIndex, isEmpty);
+	}
+
+	onValueChanged(pValue);
+}
+
 static bool pingComponent(FlowState *flowState, unsigned componentIndex, int sourceComponentIndex = -1, int sourceOutputIndex = -1, int targetInputIndex = -1) {
 	if (isComponentReadyToRun(flowState, componentIndex)) {
 		return addToQueue(flowState, componentIndex, sourceComponentIndex, sourceOutputIndex, targetInputIndex, false);
@@ -157,6 +180,8 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 			sizeof(FlowState) +
 			nValues * sizeof(Value) +
 			flow->components.count * sizeof(ComponenentExecutionState *) +
+			flow->components.count * sizeof(ComponentInputsState) +
+			flow->componentInputs.count * sizeof(uint16_t) +
 			flow->components.count * sizeof(bool),
 			0x4c3b6ef5
 		)
@@ -166,6 +191,7 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 	flowState->assets = assets;
 	flowState->flowDefinition = static_cast<FlowDefinition *>(assets->flowDefinition);
 	flowState->flow = flowDefinition->flows[flowIndex];
+	flowState->connectionsTable = getConnectionsTable(flowDefinition, flowIndex);
 	flowState->flowIndex = flowIndex;
 	flowState->error = false;
 	flowState->refCounter = 0;
@@ -177,6 +203,7 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 
 #if defined(EEZ_FOR_LVGL)
     flowState->lvglWidgetStartIndex = 0;
+    flowState->lvglPropertyCache = nullptr;
 #endif
 
     if (parentFlowState) {
@@ -213,7 +240,9 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 
 	flowState->values = (Value *)(flowState + 1);
 	flowState->componenentExecutionStates = (ComponenentExecutionState **)(flowState->values + nValues);
-    flowState->componenentAsyncStates = (bool *)(flowState->componenentExecutionStates + flow->components.count);
+    flowState->componentInputsStates = (ComponentInputsState *)(flowState->componenentExecutionStates + flow->components.count);
+    flowState->inputComponentIndexes = (uint16_t *)(flowState->componentInputsStates + flow->components.count);
+    flowState->componenentAsyncStates = (bool *)(flowState->inputComponentIndexes + flow->componentInputs.count);
 
 	for (unsigned i = 0; i < nValues; i++) {
 		new (flowState->values + i) Value();
@@ -236,6 +265,28 @@ static FlowState *initFlowState(Assets *assets, int flowIndex, FlowState *parent
 		flowState->componenentAsyncStates[i] = false;
 	}
 
+	// all inputs are empty at the start
+	for (unsigned i = 0; i < flow->componentInputs.count; i++) {
+		flowState->inputComponentIndexes[i] = NO_INPUT_COMPONENT_INDEX;
+	}
+	for (unsigned componentIndex = 0; componentIndex < flow->components.count; componentIndex++) {
+		auto component = flow->components[componentIndex];
+		auto &inputsState = flowState->componentInputsStates[componentIndex];
+		inputsState.numSeqInputs = 0;
+		inputsState.numDefinedSeqInputs = 0;
+		inputsState.numEmptyRequiredInputs = 0;
+		for (unsigned i = 0; i < component->inputs.count; i++) {
+			auto inputIndex = component->inputs[i];
+			flowState->inputComponentIndexes[inputIndex] = componentIndex;
+			auto input = flow->componentInputs[inputIndex];
+			if (input & COMPONENT_INPUT_FLAG_IS_SEQ_INPUT) {
+				inputsState.numSeqInputs++;
+			} else if (!(input & COMPONENT_INPUT_FLAG_IS_OPTIONAL)) {
+				inputsState.numEmptyRequiredInputs++;
+			}
+		}
+	}
+
 	onFlowStateCreated(flowState);
 
 	for (unsigned componentIndex = 0; componentIndex < flow->components.count; componentIndex++) {
@@ -334,6 +385,10 @@ void freeFlowState(FlowState *flowState) {
 
 	onFlowStateDestroyed(flowState);
 
+#if defined(EEZ_FOR_LVGL)
+    freeLVGLPropertyCache(flowState);
+#endif
+
 	flowState->~FlowState();
 	free(flowState);
 }
@@ -371,10 +426,8 @@ void resetSequenceInputs(FlowState *flowState) {
             for (uint32_t i = 0; i < component->inputs.count; i++) {
                 auto inputIndex = component->inputs[i];
                 if (flowState->flow->componentInputs[inputIndex] & COMPONENT_INPUT_FLAG_IS_SEQ_INPUT) {
-                    auto pValue = &flowState->values[inputIndex];
-                    if (!isInputEmpty(*pValue)) {
-                        *pValue = getEmptyInputValue();
-                        onValueChanged(pValue);
+                    if (!isInputEmpty(flowState->values[inputIndex])) {
+                        setInputValue(flowState, inputIndex, getEmptyInputValue());
                     }
                 }
             }
@@ -382,6 +435,14 @@ void resetSequenceInputs(FlowState *flowState) {
     }
 }
 
+static inline void propagateValueThroughConnection(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, const Value &value, const Connection *connection) {
+	if (flowState->values[connection->targetInputIndex] != value) {
+		setInputValue(flowState, connection->targetInputIndex, value);
+	}
+
+	pingComponent(flowState, connection->targetComponentIndex, componentIndex, outputIndex, connection->targetInputIndex);
+}
+
 void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, const Value &value) {
     if ((int)componentIndex == -1) {
         // call action flow directly
@@ -393,25 +454,22 @@ void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outp
     // Reset sequence inputs before propagate value, in case component propagates value to itself
     resetSequenceInputs(flowState);
 
-	auto component = flowState->flow->components[componentIndex];
-	auto componentOutput = component->outputs[outputIndex];
-
     auto value2 = value.getValue();
 
-	for (unsigned connectionIndex = 0; connectionIndex < componentOutput->connections.count; connectionIndex++) {
-		auto connection = componentOutput->connections[connectionIndex];
-
-		auto pValue = &flowState->values[connection->targetInputIndex];
-
-		if (*pValue != value2) {
-			*pValue = value2;
-
-			//if (!(flowState->flow->componentInputs[connection->targetInputIndex] & COMPONENT_INPUT_FLAG_IS_SEQ_INPUT)) {
-				onValueChanged(pValue);
-			//}
+	auto connectionsTable = flowState->connectionsTable;
+	if (connectionsTable) {
+		auto tableOutputIndex = connectionsTable->componentOutputsStart[componentIndex] + outputIndex;
+		auto connection = connectionsTable->connections + connectionsTable->outputConnectionsStart[tableOutputIndex];
+		auto connectionsEnd = connectionsTable->connections + connectionsTable->outputConnectionsStart[tableOutputIndex + 1];
+		for (; connection < connectionsEnd; connection++) {
+			propagateValueThroughConnection(flowState, componentIndex, outputIndex, value2, connection);
+		}
+	} else {
+		auto component = flowState->flow->components[componentIndex];
+		auto componentOutput = component->outputs[outputIndex];
+		for (unsigned connectionIndex = 0; connectionIndex < componentOutput->connections.count; connectionIndex++) {
+			propagateValueThroughConnection(flowState, componentIndex, outputIndex, value2, componentOutput->connections[connectionIndex]);
 		}
-
-		pingComponent(flowState, connection->targetComponentIndex, componentIndex, outputIndex, connection->targetInputIndex);
 	}
 }
 
@@ -421,8 +479,15 @@ void propagateValue(FlowState *flowState, unsigned componentIndex, unsigned outp
 }
 
 void propagateValueThroughSeqout(FlowState *flowState, unsigned componentIndex) {
+	if (flowState->connectionsTable) {
+		auto seqoutIndex = flowState->connectionsTable->seqoutIndexes[componentIndex];
+		if (seqoutIndex != -1) {
+			propagateValue(flowState, componentIndex, seqoutIndex);
+		}
+		return;
+	}
+
 	// find @seqout output
-	// TODO optimization hint: always place @seqout at 0-th index
 	auto component = flowState->flow->components[componentIndex];
 	for (uint32_t i = 0; i < component->outputs.count; i++) {
 		if (component->outputs[i]->isSeqOut) {
@@ -543,8 +608,7 @@ void assignValue(FlowState *flowState, int componentIndex, Value &dstValue, cons
 ////////////////////////////////////////////////////////////////////////////////
 
 void clearInputValue(FlowState *flowState, int inputIndex) {
-    flowState->values[inputIndex] = Value();
-    onValueChanged(flowState->values + inputIndex);
+    setInputValue(flowState, inputIndex, Value());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
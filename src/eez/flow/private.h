@@ -22,6 +22,8 @@ using namespace eez::gui;
 namespace eez {
 namespace flow {
 
+struct ConnectionsTable;
+
 struct GlobalVariables {
     uint32_t count;
     Value values[1];
@@ -52,11 +54,30 @@ struct CatchErrorComponenentExecutionState : public ComponenentExecutionState {
 	Value message;
 };
 
+// Keeps track of how many inputs of the component are defined,
+// so isComponentReadyToRun doesn't have to scan all the inputs.
+struct ComponentInputsState {
+    uint16_t numSeqInputs;
+    uint16_t numDefinedSeqInputs;
+    uint16_t numEmptyRequiredInputs;
+};
+
+#if defined(EEZ_FOR_LVGL)
+// Last evaluated values of the LVGL widget properties, used by eval*PropertyIfChanged
+struct LVGLPropertyCache {
+    Value *values;
+    bool *isValid;
+    uint32_t *propertyOffsets; // for each component, index of its first property in values
+    uint32_t numValues;
+};
+#endif
+
 struct FlowState {
 	uint32_t flowStateIndex;
 	Assets *assets;
 	FlowDefinition *flowDefinition;
 	Flow *flow;
+	ConnectionsTable *connectionsTable;
 	uint16_t flowIndex;
 	bool isAction;
 	bool error;
@@ -74,11 +95,14 @@ struct FlowState {
 	int parentComponentIndex;
 	Value *values;
 	ComponenentExecutionState **componenentExecutionStates;
+    ComponentInputsState *componentInputsStates;
+    uint16_t *inputComponentIndexes; // for each component input, index of the component it belongs to
     bool *componenentAsyncStates;
     unsigned executingComponentIndex;
     float timelinePosition;
 #if defined(EEZ_FOR_LVGL)
     int32_t lvglWidgetStartIndex;
+    LVGLPropertyCache *lvglPropertyCache;
 #endif
     Value eventValue;
 
@@ -88,6 +112,10 @@ struct FlowState {
     FlowState *nextSibling;
 };
 
+#if defined(EEZ_FOR_LVGL)
+void freeLVGLPropertyCache(FlowState *flowState);
+#endif
+
 extern int g_selectedLanguage;
 extern FlowState *g_firstFlowState;
 extern FlowState *g_lastFlowState;
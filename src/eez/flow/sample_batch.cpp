@@ -0,0 +1,189 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <eez/conf-internal.h>
+
+#include <string.h>
+
+#include <atomic>
+
+#include <eez/core/alloc.h>
+#include <eez/core/util.h>
+
+#include <eez/flow/sample_batch.h>
+
+namespace eez {
+namespace flow {
+
+struct SampleBatchPropagator {
+    FlowState *flowState; // nullptr when flow is stopped
+    unsigned componentIndex;
+    unsigned outputIndex;
+    uint32_t numValuesPerSample;
+    uint32_t capacity;
+    uint32_t flags;
+
+    double *values;
+
+    // head is written only by producer and tail only by flow thread
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+
+    SampleBatchPropagator *prev;
+    SampleBatchPropagator *next;
+};
+
+static SampleBatchPropagator *g_firstSampleBatchPropagator;
+
+const SampleBatch *getSampleBatch(const Value &value) {
+    if (value.getType() != VALUE_TYPE_BLOB_REF) {
+        return nullptr;
+    }
+    auto blobRef = (BlobRef *)value.refValue;
+    if (blobRef->len < sizeof(SampleBatch) - sizeof(double)) {
+        return nullptr;
+    }
+    auto sampleBatch = (const SampleBatch *)blobRef->blob;
+    if (sampleBatch->tag != SAMPLE_BATCH_TAG || sampleBatch->numValuesPerSample == 0) {
+        return nullptr;
+    }
+    // blob must hold all the values, users of the batch don't check it
+    uint64_t numValues = (uint64_t)sampleBatch->numSamples * sampleBatch->numValuesPerSample;
+    if (blobRef->len < sizeof(SampleBatch) - sizeof(double) + numValues * sizeof(double)) {
+        return nullptr;
+    }
+    return sampleBatch;
+}
+
+SampleBatchPropagator *createSampleBatchPropagator(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, uint32_t numValuesPerSample, uint32_t capacity, uint32_t flags) {
+    if (numValuesPerSample == 0 || capacity == 0) {
+        return nullptr;
+    }
+
+    auto propagator = (SampleBatchPropagator *)alloc(sizeof(SampleBatchPropagator), 0x2b9f6c13);
+    if (!propagator) {
+        return nullptr;
+    }
+
+    propagator->values = (double *)alloc(capacity * numValuesPerSample * sizeof(double), 0x9e41d07a);
+    if (!propagator->values) {
+        free(propagator);
+        return nullptr;
+    }
+
+    propagator->flowState = flowState;
+    propagator->componentIndex = componentIndex;
+    propagator->outputIndex = outputIndex;
+    propagator->numValuesPerSample = numValuesPerSample;
+    propagator->capacity = capacity;
+    propagator->flags = flags;
+
+    new (&propagator->head) std::atomic<uint32_t>(0);
+    new (&propagator->tail) std::atomic<uint32_t>(0);
+
+    propagator->prev = nullptr;
+    propagator->next = g_firstSampleBatchPropagator;
+    if (g_firstSampleBatchPropagator) {
+        g_firstSampleBatchPropagator->prev = propagator;
+    }
+    g_firstSampleBatchPropagator = propagator;
+
+    incRefCounterForFlowState(flowState);
+
+    return propagator;
+}
+
+void destroySampleBatchPropagator(SampleBatchPropagator *propagator) {
+    if (propagator->prev) {
+        propagator->prev->next = propagator->next;
+    } else {
+        g_firstSampleBatchPropagator = propagator->next;
+    }
+    if (propagator->next) {
+        propagator->next->prev = propagator->prev;
+    }
+
+    if (propagator->flowState) {
+        decRefCounterForFlowState(propagator->flowState);
+    }
+
+    free(propagator->values);
+    free(propagator);
+}
+
+uint32_t pushSamples(SampleBatchPropagator *propagator, const double *values, uint32_t numSamples) {
+    uint32_t head = propagator->head.load(std::memory_order_relaxed);
+    uint32_t tail = propagator->tail.load(std::memory_order_acquire);
+
+    uint32_t numFree = propagator->capacity - (head - tail);
+    if (numSamples > numFree) {
+        numSamples = numFree;
+    }
+
+    auto stride = propagator->numValuesPerSample;
+    for (uint32_t i = 0; i < numSamples; i++) {
+        memcpy(propagator->values + ((head + i) % propagator->capacity) * stride, values + i * stride, stride * sizeof(double));
+    }
+
+    propagator->head.store(head + numSamples, std::memory_order_release);
+
+    return numSamples;
+}
+
+static void propagateSampleBatch(SampleBatchPropagator *propagator) {
+    uint32_t tail = propagator->tail.load(std::memory_order_relaxed);
+    uint32_t head = propagator->head.load(std::memory_order_acquire);
+
+    uint32_t numSamples = head - tail;
+    if (numSamples == 0) {
+        return;
+    }
+
+    if (propagator->flowState) {
+        auto stride = propagator->numValuesPerSample;
+
+        Value value = Value::makeBlobRef(nullptr, sizeof(SampleBatch) - sizeof(double) + numSamples * stride * sizeof(double), 0x4f8a3e26);
+        if (value.getType() == VALUE_TYPE_BLOB_REF) {
+            auto sampleBatch = (SampleBatch *)((BlobRef *)value.refValue)->blob;
+            sampleBatch->tag = SAMPLE_BATCH_TAG;
+            sampleBatch->numSamples = numSamples;
+            sampleBatch->numValuesPerSample = stride;
+            sampleBatch->flags = propagator->flags;
+
+            // ring buffer content in at most two parts
+            uint32_t first = tail % propagator->capacity;
+            uint32_t n1 = MIN(numSamples, propagator->capacity - first);
+            memcpy(sampleBatch->values, propagator->values + first * stride, n1 * stride * sizeof(double));
+            memcpy(sampleBatch->values + n1 * stride, propagator->values, (numSamples - n1) * stride * sizeof(double));
+
+            propagateValue(propagator->flowState, propagator->componentIndex, propagator->outputIndex, value);
+        }
+    }
+
+    propagator->tail.store(head, std::memory_order_release);
+}
+
+void propagateSampleBatches() {
+    for (auto propagator = g_firstSampleBatchPropagator; propagator; propagator = propagator->next) {
+        propagateSampleBatch(propagator);
+    }
+}
+
+void sampleBatchPropagatorsReset() {
+    // Propagators are owned by the native code which can still push samples,
+    // so they are only detached from the freed flow states.
+    for (auto propagator = g_firstSampleBatchPropagator; propagator; propagator = propagator->next) {
+        propagator->flowState = nullptr;
+    }
+}
+
+} // namespace flow
+} // namespace eez
@@ -0,0 +1,55 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <eez/flow/private.h>
+
+namespace eez {
+namespace flow {
+
+// Batched propagation of high rate data produced by native code. Samples are
+// pushed, from any thread, into a lock-free single producer / single consumer
+// ring buffer. At the start of each flow tick all pending samples are propagated
+// through the component output as one blob value with SampleBatch layout.
+
+#define SAMPLE_BATCH_TAG 0x53424154
+
+// first value of the sample is the date (x value)
+#define SAMPLE_BATCH_FLAG_X_IS_DATE 1
+
+struct SampleBatch {
+    uint32_t tag;
+    uint32_t numSamples;
+    uint32_t numValuesPerSample;
+    uint32_t flags;
+    double values[1];
+};
+
+// Returns nullptr if value is not the blob created by sample batch propagator.
+const SampleBatch *getSampleBatch(const Value &value);
+
+struct SampleBatchPropagator;
+
+// Must be called from the flow thread. Capacity is the max. number of samples
+// waiting for the next flow tick.
+SampleBatchPropagator *createSampleBatchPropagator(FlowState *flowState, unsigned componentIndex, unsigned outputIndex, uint32_t numValuesPerSample, uint32_t capacity, uint32_t flags = 0);
+void destroySampleBatchPropagator(SampleBatchPropagator *propagator);
+
+// Can be called from any (but only one) thread. Returns the number of pushed
+// samples, it is less than numSamples if the buffer is full.
+uint32_t pushSamples(SampleBatchPropagator *propagator, const double *values, uint32_t numSamples);
+
+void propagateSampleBatches();
+void sampleBatchPropagatorsReset();
+
+} // flow
+} // eez
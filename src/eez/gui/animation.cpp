@@ -26,6 +26,63 @@ static bool g_animationStateDirection;
 static Rect g_animationStateSrcRect;
 static Rect g_animationStateDstRect;
 
+// Animation frames are composed into two alternating buffers. For each of them
+// we remember the area that was drawn over the base (old or new buffer), so the
+// next frame in the same buffer has to restore only that area and the area
+// drawn in the current frame instead of copying the whole base.
+struct AnimationBufferDamage {
+    VideoBuffer buffer;
+    uint32_t baseVersion;
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+};
+
+static AnimationBufferDamage g_animationBufferDamage[2];
+static int g_lastAnimationBufferDamage;
+
+static void copyAnimationBase(VideoBuffer bufferBase, VideoBuffer bufferDst, int x1, int y1, int x2, int y2) {
+    int i;
+    if (g_animationBufferDamage[0].buffer == bufferDst) {
+        i = 0;
+    } else if (g_animationBufferDamage[1].buffer == bufferDst) {
+        i = 1;
+    } else {
+        i = 1 - g_lastAnimationBufferDamage;
+    }
+    g_lastAnimationBufferDamage = i;
+
+    AnimationBufferDamage &damage = g_animationBufferDamage[i];
+
+    int displayX2 = getDisplayWidth() - 1;
+    int displayY2 = getDisplayHeight() - 1;
+
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 > displayX2) x2 = displayX2;
+    if (y2 > displayY2) y2 = displayY2;
+
+    if (damage.buffer != bufferDst || damage.baseVersion != g_animationState.baseVersion) {
+        bitBlt(bufferBase, bufferDst, 0, 0, displayX2, displayY2);
+        damage.buffer = bufferDst;
+        damage.baseVersion = g_animationState.baseVersion;
+    } else {
+        int copyX1 = MIN(damage.x1, x1);
+        int copyY1 = MIN(damage.y1, y1);
+        int copyX2 = MAX(damage.x2, x2);
+        int copyY2 = MAX(damage.y2, y2);
+        if (copyX1 <= copyX2 && copyY1 <= copyY2) {
+            bitBlt(bufferBase, bufferDst, copyX1, copyY1, copyX2, copyY2);
+        }
+    }
+
+    damage.x1 = x1;
+    damage.y1 = y1;
+    damage.x2 = x2;
+    damage.y2 = y2;
+}
+
 void animateOpenCloseCallback(float t, VideoBuffer bufferOld, VideoBuffer bufferNew, VideoBuffer bufferDst) {
     if (!g_animationStateDirection) {
         auto bufferTemp = bufferOld;
@@ -128,7 +185,7 @@ void animateOpenCloseCallback(float t, VideoBuffer bufferOld, VideoBuffer buffer
         }
     }
 
-    bitBlt(bufferOld, bufferDst, 0, 0, getDisplayWidth() - 1, getDisplayHeight() - 1);
+    copyAnimationBase(bufferOld, bufferDst, x1, y1, x2, y2);
     bitBlt(bufferNew, bufferDst, x1, y1, x2, y2);
 }
 
@@ -152,11 +209,16 @@ static int g_numRects;
 AnimRect g_animRects[MAX_ANIM_RECTS];
 
 void animateRectsStep(float t, VideoBuffer bufferOld, VideoBuffer bufferNew, VideoBuffer bufferDst) {
-    bitBlt(g_animationState.startBuffer == BUFFER_OLD ? bufferOld : bufferNew, bufferDst, 0, 0, getDisplayWidth() - 1, getDisplayHeight() - 1);
-
     float t1 = g_animationState.easingRects(t, 0, 0, 1, 1); // rects
     float t2 = g_animationState.easingOpacity(t, 0, 0, 1, 1); // opacity
 
+    Rect rects[MAX_ANIM_RECTS];
+
+    int damageX1 = getDisplayWidth();
+    int damageY1 = getDisplayHeight();
+    int damageX2 = -1;
+    int damageY2 = -1;
+
     for (int i = 0; i < g_numRects; i++) {
         AnimRect &animRect = g_animRects[i];
 
@@ -189,6 +251,30 @@ void animateRectsStep(float t, VideoBuffer bufferOld, VideoBuffer bufferNew, Vid
 				h = (int)floorf(animRect.srcRect.h + t1 * (animRect.dstRect.h - animRect.srcRect.h));
         }
 
+        rects[i].x = x;
+        rects[i].y = y;
+        rects[i].w = w;
+        rects[i].h = h;
+
+        // everything drawn for this rect is inside x, y, w, h
+        if (w > 0 && h > 0) {
+            damageX1 = MIN(damageX1, x);
+            damageY1 = MIN(damageY1, y);
+            damageX2 = MAX(damageX2, x + w - 1);
+            damageY2 = MAX(damageY2, y + h - 1);
+        }
+    }
+
+    copyAnimationBase(g_animationState.startBuffer == BUFFER_OLD ? bufferOld : bufferNew, bufferDst, damageX1, damageY1, damageX2, damageY2);
+
+    for (int i = 0; i < g_numRects; i++) {
+        AnimRect &animRect = g_animRects[i];
+
+        int x = rects[i].x;
+        int y = rects[i].y;
+        int w = rects[i].w;
+        int h = rects[i].h;
+
         uint8_t opacity;
         if (animRect.opacity == OPACITY_FADE_IN) {
             opacity = (uint8_t)roundf(clamp(roundf(t2 * 255), 0, 255));
@@ -218,7 +304,7 @@ void animateRectsStep(float t, VideoBuffer bufferOld, VideoBuffer bufferNew, Vid
             }
 
             if (y + h > g_clipRect.y + g_clipRect.h) {
-                h -= (y + h) - (g_clipRect.y + g_clipRect.y);
+                h -= (y + h) - (g_clipRect.y + g_clipRect.h);
             }
 
             fillRect(bufferDst, x, y, x + w - 1, y + h - 1);
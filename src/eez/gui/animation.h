@@ -47,6 +47,9 @@ struct AnimationState {
     void (*callback)(float t, VideoBuffer bufferOld, VideoBuffer bufferNew, VideoBuffer bufferDst);
     float (*easingRects)(float x, float x1, float y1, float x2, float y2);
     float (*easingOpacity)(float x, float x1, float y1, float x2, float y2);
+    // changed when animation starts and when new buffer is rendered during animation,
+    // animation buffers composed over the older base must be fully redrawn
+    uint32_t baseVersion;
 };
 
 struct AnimRect {
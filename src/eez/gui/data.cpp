@@ -431,6 +431,21 @@ Value ytDataGetCursorXValue(const WidgetCursor &widgetCursor, int16_t id) {
     return value;
 }
 
+const YTGraphEnvelope *ytDataGetEnvelope(const WidgetCursor &widgetCursor, int16_t id, uint8_t valueIndex, uint32_t &samplesPerColumn) {
+    YtDataGetEnvelopeParams params = {
+        valueIndex,
+        nullptr,
+        0
+    };
+    Value value(&params, VALUE_TYPE_POINTER);
+    DATA_OPERATION_FUNCTION(id, DATA_OPERATION_YT_DATA_GET_ENVELOPE, widgetCursor, value);
+    if (params.samplesPerColumn == 0) {
+        return nullptr;
+    }
+    samplesPerColumn = params.samplesPerColumn;
+    return params.envelope;
+}
+
 void ytDataTouchDrag(const WidgetCursor &widgetCursor, int16_t id, TouchDrag *touchDrag) {
     Value value = Value(touchDrag, VALUE_TYPE_POINTER);
     DATA_OPERATION_FUNCTION(id, DATA_OPERATION_YT_DATA_TOUCH_DRAG, widgetCursor, value);
@@ -125,7 +125,8 @@ enum DataOperationEnum {
     DATA_OPERATION_GET_X_SCROLL,
 	DATA_OPERATION_GET_SLOT_AND_SUBCHANNEL_INDEX,
 	DATA_OPERATION_IS_MICRO_AMPER_ALLOWED,
-	DATA_OPERATION_IS_AMPER_ALLOWED
+	DATA_OPERATION_IS_AMPER_ALLOWED,
+    DATA_OPERATION_YT_DATA_GET_ENVELOPE
 };
 
 int count(const WidgetCursor &widgetCursor, int16_t id);
@@ -201,6 +202,18 @@ bool ytDataIsCursorVisible(const WidgetCursor &widgetCursor, int16_t id);
 uint32_t ytDataGetCursorOffset(const WidgetCursor &widgetCursor, int16_t id);
 Value ytDataGetCursorXValue(const WidgetCursor &widgetCursor, int16_t id);
 
+// Optional, for YT_GRAPH_UPDATE_METHOD_STATIC. If the data provider sets the
+// envelope of the value, graph takes the min/max of every column from it,
+// instead of calling the get value function. Column x covers samples
+// [x * samplesPerColumn, (x + 1) * samplesPerColumn).
+struct YTGraphEnvelope;
+struct YtDataGetEnvelopeParams {
+    uint8_t valueIndex;
+    const YTGraphEnvelope *envelope;
+    uint32_t samplesPerColumn;
+};
+const YTGraphEnvelope *ytDataGetEnvelope(const WidgetCursor &widgetCursor, int16_t id, uint8_t valueIndex, uint32_t &samplesPerColumn);
+
 struct TouchDrag {
 	const WidgetCursor &widgetCursor;
     EventType type;
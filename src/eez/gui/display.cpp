@@ -31,6 +31,7 @@
 #include <eez/gui/thread.h>
 
 #include <eez/gui/display-private.h>
+#include <eez/gui/render_stats.h>
 
 #define CONF_BACKDROP_OPACITY 128
 
@@ -232,6 +233,7 @@ void animate(Buffer startBuffer, void (*callback)(float t, VideoBuffer bufferOld
     g_animationState.callback = callback;
     g_animationState.easingRects = remapOutQuad;
     g_animationState.easingOpacity = remapOutCubic;
+    g_animationState.baseVersion++;
 }
 
 static void animateStep() {
@@ -250,6 +252,10 @@ static void animateStep() {
 			g_animationBuffer = g_animationBuffer1;
 		}
 
+        if (isDirty()) {
+            g_animationState.baseVersion++;
+        }
+
         if (g_renderBuffer == g_renderBuffer1) {
             g_animationState.callback(t, g_renderBuffer2, g_renderBuffer1, g_animationBuffer);
         } else {
@@ -284,10 +290,18 @@ void update() {
 	g_lastTimeFPS = millis();
 #endif
 
+#if EEZ_OPTION_GUI_RENDER_STATS
+    auto frameStartTime = getRenderStatsTime();
+#endif
+
     display::beginRendering();
     updateScreen();
     display::endRendering();
 
+#if EEZ_OPTION_GUI_RENDER_STATS
+    onFrameRendered(getRenderStatsTime() - frameStartTime);
+#endif
+
 #ifdef GUI_CALC_FPS
     if (g_calcFpsEnabled) {
         calcFPS();
@@ -296,7 +310,13 @@ void update() {
 
 #if EEZ_OPTION_GUI_ANIMATIONS
     if (!g_screenshotAllocated && g_animationState.enabled) {
+#if EEZ_OPTION_GUI_RENDER_STATS
+        auto animationStartTime = getRenderStatsTime();
         animateStep();
+        onAnimationFrameRendered(getRenderStatsTime() - animationStartTime);
+#else
+        animateStep();
+#endif
     } else {
 #endif
         g_syncedBuffer = g_renderBuffer;
@@ -948,7 +968,7 @@ void fillRoundedRect(
 ////////////////////////////////////////////////////////////////////////////////
 
 static int8_t measureGlyph(int32_t encoding) {
-    auto glyph = g_font.getGlyph(encoding);
+    auto glyph = g_font.getGlyphMetrics(encoding);
     if (!glyph)
         return 0;
 
@@ -956,7 +976,7 @@ static int8_t measureGlyph(int32_t encoding) {
 }
 
 int8_t measureGlyph(int32_t encoding, gui::font::Font &font) {
-    auto glyph = font.getGlyph(encoding);
+    auto glyph = font.getGlyphMetrics(encoding);
     if (!glyph)
         return 0;
 
@@ -1026,8 +1046,15 @@ void drawStr(const char *text, int textLength, int x, int y, int clip_x1, int cl
         auto x1 = x;
         auto y1 = y;
 
-        auto glyph = g_font.getGlyph(encoding);
-        if (glyph) {
+        auto glyphMetrics = g_font.getGlyphMetrics(encoding);
+        if (glyphMetrics) {
+            // if pixels of a chunked glyph can't be loaded glyph is skipped, but the text is still advanced
+            auto glyph = gui::font::Font::getGlyphPixels(glyphMetrics);
+            if (!glyph) {
+                x += glyphMetrics->dx;
+                continue;
+            }
+
             int x_glyph = x1 + glyph->x;
             int y_glyph = y1 + g_font.getAscent() - (glyph->y + glyph->height);
 
@@ -1098,7 +1125,7 @@ int getCharIndexAtPosition(int xPos, const char *text, int textLength, int x, in
             break;
         }
 
-        auto glyph = font.getGlyph(encoding);
+        auto glyph = font.getGlyphMetrics(encoding);
         auto dx = 0;
         if (glyph) {
             dx = glyph->dx;
@@ -1128,7 +1155,7 @@ int getCursorXPosition(int cursorPosition, const char *text, int textLength, int
             return x;
         }
 
-        auto glyph = font.getGlyph(encoding);
+        auto glyph = font.getGlyphMetrics(encoding);
         if (glyph) {
             x += glyph->dx;
         }
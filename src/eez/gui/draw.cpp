@@ -16,7 +16,9 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+#include <eez/core/alloc.h>
 #include <eez/core/util.h>
+#include <eez/core/utf8.h>
 
 #include <eez/gui/gui.h>
 
@@ -66,7 +68,7 @@ void drawBorderAndBackground(int &x1, int &y1, int &x2, int &y2, const Style *st
 			isTransparent = false;
 		} else if (style->backgroundImage) {
 			auto bitmap = getBitmap(style->backgroundImage);
-			if (bitmap->bpp != 32) {
+			if (bitmap && bitmap->bpp != 32) {
 				// non-transparent bitmap
 				isTransparent = false;
 			}
@@ -451,111 +453,196 @@ int getCursorXPosition(int cursorPosition, const char *text, int textLength, int
 
 static const unsigned int CONF_MULTILINE_TEXT_MAX_LINE_LENGTH = 1000;
 
-enum MultilineTextRenderStep {
-    MEASURE,
-    RENDER
+struct MultilineTextLine {
+    // byte offsets of the first and one past the last character of the line,
+    // runs of spaces inside are collapsed to a single space when drawn
+    uint32_t start;
+    uint32_t end;
+    int16_t y; // relative to the top of the text
+    int16_t indent;
+    int16_t width; // including indent
 };
 
-struct MultilineTextRender {
-    const char *text;
-    int x1;
-    int y1;
-    int x2;
-    int y2;
+// Line breaks of the text laid out inside the content box (w x h) of the style.
+struct MultilineTextLayout {
+    uint32_t textHash;
+    uint32_t textLength;
     const Style *style;
-    bool active;
+    const void *fontData;
+    int w;
+    int h;
     int firstLineIndent;
     int hangingIndent;
 
+    MultilineTextLine *lines;
+    uint32_t numLines;
+    int textHeight;
+
+    uint32_t lastUsed;
+};
+
+static MultilineTextLayout g_multilineTextLayoutCache[EEZ_GUI_MULTILINE_TEXT_LAYOUT_CACHE_SIZE];
+static uint32_t g_multilineTextLayoutCacheCounter;
+
+// lines of the layout in progress, grows on demand and is kept between calls
+static MultilineTextLine *g_multilineTextLines;
+static uint32_t g_multilineTextLinesCapacity;
+
+// used, without caching, when there is no memory to store the lines in the cache
+static MultilineTextLayout g_uncachedMultilineTextLayout;
+
+struct MultilineTextLayoutBuilder {
+    const char *text;
     font::Font font;
+    int maxWidth;
+    int maxHeight;
+    int lineHeight;
     int spaceWidth;
+    int hangingIndent;
 
-    int lineHeight;
+    uint32_t numLines;
     int textHeight;
 
-    char line[CONF_MULTILINE_TEXT_MAX_LINE_LENGTH + 1];
+    uint32_t lineStart;
+    uint32_t lineEnd;
+    bool lineIsEmpty;
     int lineIndent;
     int lineWidth;
 
-    void appendToLine(const char *str, size_t n) {
-        size_t j = strlen(line);
-        for (size_t i = 0; i < n && j < CONF_MULTILINE_TEXT_MAX_LINE_LENGTH; i++, j++) {
-            line[j] = str[i];
+    void addLine(int y) {
+        if (numLines == g_multilineTextLinesCapacity) {
+            uint32_t capacity = g_multilineTextLinesCapacity ? 2 * g_multilineTextLinesCapacity : 32;
+            auto lines = (MultilineTextLine *)alloc(capacity * sizeof(MultilineTextLine), 0x6a1e7c05);
+            if (!lines) {
+                // out of memory, the rest of the text is not displayed
+                return;
+            }
+            if (g_multilineTextLines) {
+                memcpy(lines, g_multilineTextLines, numLines * sizeof(MultilineTextLine));
+                free(g_multilineTextLines);
+            }
+            g_multilineTextLines = lines;
+            g_multilineTextLinesCapacity = capacity;
         }
-        line[j] = 0;
+
+        auto &line = g_multilineTextLines[numLines++];
+        line.start = lineStart;
+        line.end = lineEnd;
+        line.y = (int16_t)y;
+        line.indent = (int16_t)lineIndent;
+        line.width = (int16_t)lineWidth;
     }
 
-    void flushLine(int y, MultilineTextRenderStep step) {
-        if (line[0] && lineWidth) {
-            if (step == RENDER) {
-                int x;
+    void flushLine(int y) {
+        if (!lineIsEmpty && lineWidth) {
+            addLine(y);
+            textHeight = MAX(textHeight, y + lineHeight);
 
-                if (styleIsHorzAlignLeft(style)) {
-                    x = x1;
-                } else if (styleIsHorzAlignRight(style)) {
-                    x = x2 + 1 - lineWidth;
-                } else {
-                    x = x1 + int((x2 - x1 + 1 - lineWidth) / 2);
-                }
+            lineIsEmpty = true;
+            lineWidth = lineIndent = hangingIndent;
+        }
+    }
 
-                display::drawStr(line, -1, x + lineIndent, y, x, y, x + lineWidth - 1, y + font.getHeight() - 1, font, -1);
-            } else {
-                textHeight = MAX(textHeight, y + lineHeight - y1);
-            }
+    void appendToLine(uint32_t start, uint32_t end, int wordWidth) {
+        if (start == end) {
+            return;
+        }
+        if (lineIsEmpty) {
+            lineStart = start;
+            lineIsEmpty = false;
+        } else {
+            lineWidth += spaceWidth;
+        }
+        lineEnd = end;
+        lineWidth += wordWidth;
+    }
 
-            line[0] = 0;
-            lineWidth = lineIndent = hangingIndent;
+    // Finds the longest part of the word starting at start not wider than maxWidth,
+    // at least one glyph is returned so the layout always progresses.
+    uint32_t fitWord(uint32_t start, uint32_t end, int maxWidth, int &fitWidth) {
+        fitWidth = 0;
+        uint32_t i = start;
+        while (i < end) {
+            utf8_int32_t encoding;
+            uint32_t next = utf8codepoint(text + i, &encoding) - text;
+            int glyphWidth = display::measureGlyph(encoding, font);
+            if (i > start && fitWidth + glyphWidth > maxWidth) {
+                break;
+            }
+            fitWidth += glyphWidth;
+            i = next;
         }
+        return i;
     }
 
-    int executeStep(MultilineTextRenderStep step) {
+    // Every glyph is measured once. Returns the height of the text.
+    int layout(int firstLineIndent) {
+        numLines = 0;
         textHeight = 0;
 
-        int y = y1;
+        int y = 0;
 
-        line[0] = 0;
+        lineIsEmpty = true;
         lineWidth = lineIndent = firstLineIndent;
 
-        int i = 0;
+        uint32_t i = 0;
+
+        // the part of the word that didn't fit into the previous line
+        bool isWordRemainder = false;
+        uint32_t wordEnd = 0;
+        int wordWidth = 0;
+
         while (true) {
-            int j = i;
-            while (text[i] != 0 && text[i] != ' ' && text[i] != '\n')
-                ++i;
+            uint32_t j = i;
+
+            if (!isWordRemainder) {
+                wordWidth = 0;
+                while (text[i] != 0 && text[i] != ' ' && text[i] != '\n') {
+                    utf8_int32_t encoding;
+                    i = utf8codepoint(text + i, &encoding) - text;
+                    wordWidth += display::measureGlyph(encoding, font);
+                }
+                wordEnd = i;
+            }
+            isWordRemainder = false;
 
-            int width = display::measureStr(text + j, i - j, font);
+            uint32_t end = wordEnd;
+            int width = wordWidth;
 
-            while (lineWidth + (line[0] ? spaceWidth : 0) + width > x2 - x1 + 1) {
-				if (!line[0]) {
-					i--;
-					width = display::measureStr(text + j, i - j, font);
-					continue;
-				}
+            while (lineWidth + (lineIsEmpty ? 0 : spaceWidth) + width > maxWidth) {
+                if (lineIsEmpty) {
+                    end = fitWord(j, wordEnd, maxWidth - lineWidth, width);
+                    break;
+                }
 
-                flushLine(y, step);
+                flushLine(y);
 
                 y += lineHeight;
-                if (y + lineHeight - 1 > y2) {
+                if (y + lineHeight > maxHeight) {
                     break;
                 }
             }
 
-            if (y + lineHeight - 1 > y2) {
+            if (y + lineHeight > maxHeight) {
                 break;
             }
 
-            if (line[0]) {
-                appendToLine(" ", 1);
-                lineWidth += spaceWidth;
+            appendToLine(j, end, width);
+
+            i = end;
+
+            if (end < wordEnd) {
+                isWordRemainder = true;
+                wordWidth -= width;
+                continue;
             }
-            appendToLine(text + j, i - j);
-            lineWidth += width;
 
             while (text[i] == ' ') {
                 ++i;
             }
 
             if (text[i] == 0 || text[i] == '\n') {
-                flushLine(y, step);
+                flushLine(y);
 
                 y += lineHeight;
 
@@ -568,110 +655,180 @@ struct MultilineTextRender {
                 int extraHeightBetweenParagraphs = (int)(0.2 * lineHeight);
                 y += extraHeightBetweenParagraphs;
 
-                if (y + lineHeight - 1 > y2) {
+                if (y + lineHeight > maxHeight) {
                     break;
                 }
             }
         }
 
-        flushLine(y, step);
+        flushLine(y);
 
         return textHeight + font.getHeight() - lineHeight;
     }
+};
 
-    int measure() {
-        x1 += style->borderSizeLeft;
-        y1 += style->borderSizeTop;
-        x2 -= style->borderSizeRight;
-        y2 -= style->borderSizeBottom;
+static void freeMultilineTextLayout(MultilineTextLayout &layout) {
+    if (layout.lines) {
+        free(layout.lines);
+        layout.lines = nullptr;
+    }
+    layout.style = nullptr;
+    layout.numLines = 0;
+}
+
+// Returns the layout of the text from the cache, laying it out on a miss.
+// Returns nullptr if the style has no font.
+static const MultilineTextLayout *getMultilineTextLayout(const char *text, const Style *style, int w, int h, int firstLineIndent, int hangingIndent) {
+    font::Font font = styleGetFont(style);
 
-        font = styleGetFont(style);
+    int lineHeight = (int)(0.9 * font.getHeight());
+    if (lineHeight <= 0) {
+        return nullptr;
+    }
 
-        lineHeight = (int)(0.9 * font.getHeight());
-        if (lineHeight <= 0) {
-            return 0;
+    uint32_t textLength = strlen(text);
+    uint32_t textHash = crc32((const uint8_t *)text, textLength);
+
+    MultilineTextLayout *layout = nullptr;
+    for (int i = 0; i < EEZ_GUI_MULTILINE_TEXT_LAYOUT_CACHE_SIZE; i++) {
+        auto &entry = g_multilineTextLayoutCache[i];
+        if (
+            entry.style == style &&
+            entry.fontData == font.fontData &&
+            entry.textHash == textHash &&
+            entry.textLength == textLength &&
+            entry.w == w &&
+            entry.h == h &&
+            entry.firstLineIndent == firstLineIndent &&
+            entry.hangingIndent == hangingIndent
+        ) {
+            entry.lastUsed = ++g_multilineTextLayoutCacheCounter;
+            return &entry;
         }
 
-        auto spaceGlyph = font.getGlyph(' ');
-        spaceWidth = spaceGlyph->dx;
+        if (!layout || (layout->style && (!entry.style || entry.lastUsed < layout->lastUsed))) {
+            layout = &entry;
+        }
+    }
+
+    MultilineTextLayoutBuilder builder;
+    builder.text = text;
+    builder.font = font;
+    builder.maxWidth = w;
+    builder.maxHeight = h;
+    builder.lineHeight = lineHeight;
+    auto spaceGlyph = font.getGlyphMetrics(' ');
+    builder.spaceWidth = spaceGlyph ? spaceGlyph->dx : 0;
+    builder.hangingIndent = hangingIndent;
+
+    int textHeight = builder.layout(firstLineIndent);
+
+    freeMultilineTextLayout(*layout);
+
+    if (builder.numLines > 0) {
+        layout->lines = (MultilineTextLine *)alloc(builder.numLines * sizeof(MultilineTextLine), 0x3f90b2d8);
+        if (!layout->lines) {
+            g_uncachedMultilineTextLayout.lines = g_multilineTextLines;
+            g_uncachedMultilineTextLayout.numLines = builder.numLines;
+            g_uncachedMultilineTextLayout.textHeight = textHeight;
+            return &g_uncachedMultilineTextLayout;
+        }
+        memcpy(layout->lines, g_multilineTextLines, builder.numLines * sizeof(MultilineTextLine));
+    }
+
+    layout->textHash = textHash;
+    layout->textLength = textLength;
+    layout->style = style;
+    layout->fontData = font.fontData;
+    layout->w = w;
+    layout->h = h;
+    layout->firstLineIndent = firstLineIndent;
+    layout->hangingIndent = hangingIndent;
+    layout->numLines = builder.numLines;
+    layout->textHeight = textHeight;
+    layout->lastUsed = ++g_multilineTextLayoutCacheCounter;
+
+    return layout;
+}
+
+void drawMultilineText(const char *text, int x, int y, int w, int h, const Style *style, bool active, bool blinking, int firstLineIndent, int hangingIndent) {
+    active = active || blinking;
+
+    int x1 = x;
+    int y1 = y;
+    int x2 = x + w - 1;
+    int y2 = y + h - 1;
+
+    drawBorderAndBackground(x1, y1, x2, y2, style, active ? style->activeBackgroundColor : style->backgroundColor);
+
+    uint16_t color = active ? style->activeColor : style->color;
+    if (color == TRANSPARENT_COLOR_INDEX) {
+        return;
+    }
 
-        x1 += style->paddingLeft;
-        x2 -= style->paddingRight;
-        y1 += style->paddingTop;
-        y2 -= style->paddingBottom;
+    x1 += style->paddingLeft;
+    x2 -= style->paddingRight;
+    y1 += style->paddingTop;
+    y2 -= style->paddingBottom;
 
-        return executeStep(MEASURE);
+    auto layout = getMultilineTextLayout(text, style, x2 - x1 + 1, y2 - y1 + 1, firstLineIndent, hangingIndent);
+    if (!layout) {
+        return;
     }
 
-    void render() {
-        drawBorderAndBackground(x1, y1, x2, y2, style, active ? style->activeBackgroundColor : style->backgroundColor);
+    if (styleIsVertAlignTop(style)) {
+    } else if (styleIsVertAlignBottom(style)) {
+        y1 = y2 + 1 - layout->textHeight;
+    } else {
+        y1 += (int)((y2 - y1 + 1 - layout->textHeight) / 2);
+    }
 
-        //
-        font = styleGetFont(style);
+    display::setColor(color);
 
-        lineHeight = (int)(0.9 * font.getHeight());
-        if (lineHeight <= 0) {
-            return;
-        }
+    font::Font font = styleGetFont(style);
 
-        auto spaceGlyph = font.getGlyph(' ');
-        spaceWidth = spaceGlyph->dx;
+    char line[CONF_MULTILINE_TEXT_MAX_LINE_LENGTH + 1];
 
-        // draw text
-        uint16_t color = active ? style->activeColor : style->color;
-        display::setColor(color);
+    for (uint32_t lineIndex = 0; lineIndex < layout->numLines; lineIndex++) {
+        auto &textLine = layout->lines[lineIndex];
 
-        x1 += style->paddingLeft;
-        x2 -= style->paddingRight;
-        y1 += style->paddingTop;
-        y2 -= style->paddingBottom;
+        uint32_t j = 0;
+        for (uint32_t i = textLine.start; i < textLine.end && j < CONF_MULTILINE_TEXT_MAX_LINE_LENGTH; i++) {
+            if (text[i] != ' ' || text[i - 1] != ' ') {
+                line[j++] = text[i];
+            }
+        }
+        line[j] = 0;
 
-        int textHeight = executeStep(MEASURE);
+        int lineWidth = textLine.width;
 
-        if (styleIsVertAlignTop(style)) {
-        } else if (styleIsVertAlignBottom(style)) {
-            y1 = y2 + 1 - textHeight;
+        int x;
+        if (styleIsHorzAlignLeft(style)) {
+            x = x1;
+        } else if (styleIsHorzAlignRight(style)) {
+            x = x2 + 1 - lineWidth;
         } else {
-            y1 += (int)((y2 - y1 + 1 - textHeight) / 2);
+            x = x1 + int((x2 - x1 + 1 - lineWidth) / 2);
         }
-        y2 = y1 + textHeight - 1;
 
-        if (color != TRANSPARENT_COLOR_INDEX) {
-            executeStep(RENDER);
-        }
-    }
-};
+        int y = y1 + textLine.y;
 
-void drawMultilineText(const char *text, int x, int y, int w, int h, const Style *style, bool active, bool blinking, int firstLineIndent, int hangingIndent) {
-    MultilineTextRender multilineTextRender;
-
-    multilineTextRender.text = text;
-    multilineTextRender.x1 = x;
-    multilineTextRender.y1 = y;
-    multilineTextRender.x2 = x + w - 1;
-    multilineTextRender.y2 = y + h - 1;
-    multilineTextRender.style = style;
-    multilineTextRender.active = active || blinking;
-    multilineTextRender.firstLineIndent = firstLineIndent;
-    multilineTextRender.hangingIndent = hangingIndent;
-
-    multilineTextRender.render();
+        display::drawStr(line, -1, x + textLine.indent, y, x, y, x + lineWidth - 1, y + font.getHeight() - 1, font, -1);
+    }
 }
 
 int measureMultilineText(const char *text, int x, int y, int w, int h, const Style *style, int firstLineIndent, int hangingIndent) {
-    MultilineTextRender multilineTextRender;
-
-    multilineTextRender.text = text;
-    multilineTextRender.x1 = x;
-    multilineTextRender.y1 = y;
-    multilineTextRender.x2 = x + w - 1;
-    multilineTextRender.y2 = y + h - 1;
-    multilineTextRender.style = style;
-    multilineTextRender.active = false;
-    multilineTextRender.firstLineIndent = firstLineIndent;
-    multilineTextRender.hangingIndent = hangingIndent;
-
-    return multilineTextRender.measure();
+    int x1 = x + style->borderSizeLeft + style->paddingLeft;
+    int y1 = y + style->borderSizeTop + style->paddingTop;
+    int x2 = x + w - 1 - style->borderSizeRight - style->paddingRight;
+    int y2 = y + h - 1 - style->borderSizeBottom - style->paddingBottom;
+
+    auto layout = getMultilineTextLayout(text, style, x2 - x1 + 1, y2 - y1 + 1, firstLineIndent, hangingIndent);
+    if (!layout) {
+        return 0;
+    }
+
+    return layout->textHeight;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -875,6 +1032,102 @@ void drawAntialiasedLine(int x0, int y0, int x1, int y1) {
     display::endPixelsDraw();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+bool moveRect(int x, int y, int w, int h, int dx, int dy) {
+    if (w <= 0 || h <= 0) {
+        return true;
+    }
+
+    if (
+        MIN(x, x + dx) < 0 || MIN(y, y + dy) < 0 ||
+        MAX(x, x + dx) + w > display::getDisplayWidth() || MAX(y, y + dy) + h > display::getDisplayHeight()
+    ) {
+        return false;
+    }
+
+    // wait for pending DMA drawing
+    display::startPixelsDraw();
+
+    auto buffer = display::getBufferPointer();
+    auto lineSize = w * DISPLAY_BPP / 8;
+
+    // when moving down start from the bottom line so no line is overwritten before it is moved
+    for (int i = 0; i < h; i++) {
+        int line = dy > 0 ? h - 1 - i : i;
+        auto src = buffer + (y + line) * DISPLAY_WIDTH + x;
+        memmove(src + dy * DISPLAY_WIDTH + dx, src, lineSize);
+    }
+
+    display::endPixelsDraw();
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+RetainedLayer::~RetainedLayer() {
+    eez::free(pixels);
+}
+
+bool RetainedLayer::capture(int x, int y, int w, int h, uint32_t key_) {
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > display::getDisplayWidth() || y + h > display::getDisplayHeight()) {
+        invalidate();
+        return false;
+    }
+
+    if (!pixels || width != w || height != h) {
+        eez::free(pixels);
+        pixels = eez::alloc(w * h * DISPLAY_BPP / 8, 0x7e1a9c42);
+        if (!pixels) {
+            invalidate();
+            return false;
+        }
+        width = w;
+        height = h;
+    }
+
+    key = key_;
+
+    // wait for pending DMA drawing
+    display::startPixelsDraw();
+
+    auto src = display::getBufferPointer() + y * DISPLAY_WIDTH + x;
+    auto dst = (decltype(src))pixels;
+    for (int i = 0; i < h; i++, src += DISPLAY_WIDTH, dst += w) {
+        memcpy(dst, src, w * DISPLAY_BPP / 8);
+    }
+
+    display::endPixelsDraw();
+
+    return true;
+}
+
+bool RetainedLayer::draw(int x, int y) {
+    if (!pixels || x < 0 || y < 0 || x + width > display::getDisplayWidth() || y + height > display::getDisplayHeight()) {
+        return false;
+    }
+
+    display::startPixelsDraw();
+
+    auto dst = display::getBufferPointer() + y * DISPLAY_WIDTH + x;
+    auto src = (decltype(dst))pixels;
+    for (int i = 0; i < height; i++, src += width, dst += DISPLAY_WIDTH) {
+        memcpy(dst, src, width * DISPLAY_BPP / 8);
+    }
+
+    display::endPixelsDraw();
+
+    return true;
+}
+
+void RetainedLayer::invalidate() {
+    eez::free(pixels);
+    pixels = nullptr;
+    width = 0;
+    height = 0;
+}
+
 } // namespace gui
 } // namespace eez
 
@@ -48,5 +48,37 @@ void expandRectWithShadow(int &x1, int &y1, int &x2, int &y2);
 void drawLine(int x1, int y1, int x2, int y2);
 void drawAntialiasedLine(int x1, int y1, int x2, int y2);
 
+// Moves already rendered pixels of the w x h rectangle at (x, y) by (dx, dy)
+// inside the current render buffer, source and destination may overlap.
+// Returns false, without drawing anything, if either rectangle is off screen.
+bool moveRect(int x, int y, int w, int h, int dx, int dy);
+
+// Off-screen copy of the static part of a widget. The widget draws the static
+// part into the frame buffer and captures it, later renders restore it with
+// draw() and only draw the dynamic part on top. The key identifies everything
+// the static part depends on (colors, range, labels, ...).
+struct RetainedLayer {
+    RetainedLayer() : pixels(nullptr), width(0), height(0), key(0) {}
+    ~RetainedLayer();
+
+    // owns the pixels
+    RetainedLayer(const RetainedLayer &) = delete;
+    RetainedLayer &operator=(const RetainedLayer &) = delete;
+
+    bool isValid(int w, int h, uint32_t key_) const {
+        return pixels && width == w && height == h && key == key_;
+    }
+
+    bool capture(int x, int y, int w, int h, uint32_t key);
+    bool draw(int x, int y);
+    void invalidate();
+
+private:
+    void *pixels;
+    int width;
+    int height;
+    uint32_t key;
+};
+
 } // namespace gui
 } // namespace eez
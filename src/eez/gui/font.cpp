@@ -13,6 +13,7 @@
 #if EEZ_OPTION_GUI
 
 #include <eez/gui/font.h>
+#include <eez/core/assets_chunks.h>
 
 namespace eez {
 namespace gui {
@@ -41,6 +42,14 @@ uint8_t Font::getHeight() {
 }
 
 const GlyphData *Font::getGlyph(int32_t encoding) {
+	auto glyphMetrics = getGlyphMetrics(encoding);
+	if (!glyphMetrics) {
+		return nullptr;
+	}
+	return getGlyphPixels(glyphMetrics);
+}
+
+const GlyphData *Font::getGlyphMetrics(int32_t encoding) {
 	auto start = fontData->encodingStart;
 	auto end = fontData->encodingEnd;
 
@@ -72,6 +81,13 @@ const GlyphData *Font::getGlyph(int32_t encoding) {
 	return glyphData;
 }
 
+const GlyphData *Font::getGlyphPixels(const GlyphData *glyphMetrics) {
+	if (glyphMetrics->flags & GLYPH_FLAG_CHUNKED) {
+		return loadChunkedGlyph(glyphMetrics);
+	}
+	return glyphMetrics;
+}
+
 } // namespace font
 } // namespace gui
 } // namespace eez
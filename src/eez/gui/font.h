@@ -28,8 +28,19 @@ struct Font {
 		return fontData != nullptr;
 	}
 
+    // Glyph with pixels, nullptr for missing or empty glyph or if the chunk
+    // of a chunked glyph can't be loaded. For chunked glyphs the returned
+    // pointer is valid only until the next getGlyph or getBitmap call.
     const GlyphData *getGlyph(int32_t encoding);
 
+    // Glyph metrics (dx, x, y, width, height and flags) without decompressing
+    // the pixels of a chunked glyph, pixels must not be accessed through it.
+    const GlyphData *getGlyphMetrics(int32_t encoding);
+
+    // Glyph with pixels for the glyph returned by getGlyphMetrics,
+    // same lifetime rules as for getGlyph.
+    static const GlyphData *getGlyphPixels(const GlyphData *glyphMetrics);
+
     uint8_t getAscent();
     uint8_t getDescent();
     uint8_t getHeight();
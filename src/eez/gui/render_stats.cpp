@@ -0,0 +1,76 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <eez/conf-internal.h>
+
+#if EEZ_OPTION_GUI && EEZ_OPTION_GUI_RENDER_STATS
+
+#include <string.h>
+
+#include <chrono>
+
+#include <eez/gui/render_stats.h>
+
+namespace eez {
+namespace gui {
+
+WidgetTypeRenderStats g_widgetTypeRenderStats[NUM_WIDGET_TYPES];
+FrameRenderStats g_frameRenderStats;
+FrameRenderStats g_animationFrameRenderStats;
+
+void resetRenderStats() {
+    memset(g_widgetTypeRenderStats, 0, sizeof(g_widgetTypeRenderStats));
+    memset(&g_frameRenderStats, 0, sizeof(g_frameRenderStats));
+    memset(&g_animationFrameRenderStats, 0, sizeof(g_animationFrameRenderStats));
+}
+
+uint64_t getRenderStatsTime() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void addFrameTime(FrameRenderStats &stats, uint64_t frameTimeNs) {
+    if (stats.numFrames == 0 || frameTimeNs < stats.minFrameTimeNs) {
+        stats.minFrameTimeNs = frameTimeNs;
+    }
+    if (frameTimeNs > stats.maxFrameTimeNs) {
+        stats.maxFrameTimeNs = frameTimeNs;
+    }
+    stats.lastFrameTimeNs = frameTimeNs;
+    stats.totalFrameTimeNs += frameTimeNs;
+    stats.numFrames++;
+}
+
+void onFrameRendered(uint64_t frameTimeNs) {
+    addFrameTime(g_frameRenderStats, frameTimeNs);
+}
+
+void onAnimationFrameRendered(uint64_t frameTimeNs) {
+    addFrameTime(g_animationFrameRenderStats, frameTimeNs);
+}
+
+#define WIDGET_TYPE(NAME_PASCAL_CASE, NAME, ID) #NAME_PASCAL_CASE,
+static const char *g_widgetTypeNames[] = {
+    WIDGET_TYPES
+};
+#undef WIDGET_TYPE
+
+const char *getWidgetTypeName(int widgetType) {
+    if (widgetType < 0 || widgetType >= NUM_WIDGET_TYPES) {
+        return "?";
+    }
+    return g_widgetTypeNames[widgetType];
+}
+
+} // namespace gui
+} // namespace eez
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include <eez/conf-internal.h>
+
+#if EEZ_OPTION_GUI && EEZ_OPTION_GUI_RENDER_STATS
+
+#include <eez/gui/widget.h>
+
+namespace eez {
+namespace gui {
+
+#define WIDGET_TYPE(NAME_PASCAL_CASE, NAME, ID) + 1
+static const int NUM_WIDGET_TYPES = 0 WIDGET_TYPES;
+#undef WIDGET_TYPE
+
+struct WidgetTypeRenderStats {
+    uint32_t numRenders;
+    uint64_t renderTimeNs;
+    // sum of the areas of the rendered widgets
+    uint64_t numPixels;
+};
+
+struct FrameRenderStats {
+    uint32_t numFrames;
+    uint64_t lastFrameTimeNs;
+    uint64_t totalFrameTimeNs;
+    uint64_t minFrameTimeNs;
+    uint64_t maxFrameTimeNs;
+};
+
+extern WidgetTypeRenderStats g_widgetTypeRenderStats[NUM_WIDGET_TYPES];
+extern FrameRenderStats g_frameRenderStats;
+// composing of page transition animation frames, not included in g_frameRenderStats
+extern FrameRenderStats g_animationFrameRenderStats;
+
+void resetRenderStats();
+
+// monotonic time in nanoseconds
+uint64_t getRenderStatsTime();
+
+void onFrameRendered(uint64_t frameTimeNs);
+void onAnimationFrameRendered(uint64_t frameTimeNs);
+
+const char *getWidgetTypeName(int widgetType);
+
+} // namespace gui
+} // namespace eez
+
+#endif
@@ -15,6 +15,7 @@
 #include <assert.h>
 #include <cstddef>
 #include <limits.h>
+#include <algorithm>
 
 #include <eez/core/debug.h>
 #include <eez/core/os.h>
@@ -24,6 +25,7 @@
 #include <eez/core/assets.h>
 
 #include <eez/gui/draw.h>
+#include <eez/gui/render_stats.h>
 
 #include <eez/gui/widgets/containers/app_view.h>
 #include <eez/gui/widgets/containers/container.h>
@@ -158,10 +160,23 @@ void WidgetCursor::popBackground() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#if EEZ_OPTION_GUI_RENDER_STATS
+#define RENDER_WIDGET_STATE() { \
+        auto renderStartTime = getRenderStatsTime(); \
+        widgetState->render(); \
+        auto &renderStats = g_widgetTypeRenderStats[widget->type]; \
+        renderStats.numRenders++; \
+        renderStats.renderTimeNs += getRenderStatsTime() - renderStartTime; \
+        renderStats.numPixels += widgetCursor.w * widgetCursor.h; \
+    }
+#else
+#define RENDER_WIDGET_STATE() widgetState->render()
+#endif
+
 #define RENDER_WIDGET() \
     if ((!widget->visible || widgetState->isVisible.toBool()) && widgetCursor.opacity > 0) { \
         auto savedOpacity = display::setOpacity(widgetCursor.opacity); \
-        widgetState->render(); \
+        RENDER_WIDGET_STATE(); \
         display::setOpacity(savedOpacity); \
     } else { \
         int x1 = g_widgetCursor.x; \
@@ -262,6 +277,85 @@ void freeWidgetStates(WidgetState *widgetStateStart) {
 	}
 }
 
+// Widget states that can be moved to another place in the state buffer as raw
+// bytes: they don't own memory and nothing points into them. Contained Values
+// are fine, moved Value takes its reference with it and the old bytes are
+// overwritten without being destructed.
+static bool isRelocatableWidgetState(uint16_t type) {
+    switch (type) {
+    case WIDGET_TYPE_NONE:
+    case WIDGET_TYPE_CONTAINER:
+    case WIDGET_TYPE_LIST:
+    case WIDGET_TYPE_GRID:
+    case WIDGET_TYPE_SELECT:
+    case WIDGET_TYPE_DISPLAY_DATA:
+    case WIDGET_TYPE_TEXT:
+    case WIDGET_TYPE_MULTILINE_TEXT:
+    case WIDGET_TYPE_RECTANGLE:
+    case WIDGET_TYPE_BITMAP:
+    case WIDGET_TYPE_BUTTON:
+    case WIDGET_TYPE_TOGGLE_BUTTON:
+    case WIDGET_TYPE_BUTTON_GROUP:
+    case WIDGET_TYPE_BAR_GRAPH:
+    case WIDGET_TYPE_USER_WIDGET:
+    case WIDGET_TYPE_UP_DOWN:
+    case WIDGET_TYPE_LIST_GRAPH:
+    case WIDGET_TYPE_SCROLL_BAR:
+    case WIDGET_TYPE_PROGRESS:
+    case WIDGET_TYPE_CANVAS:
+    case WIDGET_TYPE_INPUT:
+    case WIDGET_TYPE_SWITCH:
+    case WIDGET_TYPE_SLIDER:
+    case WIDGET_TYPE_DROP_DOWN_LIST:
+    case WIDGET_TYPE_LINE_CHART:
+    case WIDGET_TYPE_QR_CODE:
+        return true;
+    default:
+        // Roller and Gauge own memory (labels, retained layer), YTGraph and
+        // AppView are not used as list items
+        return false;
+    }
+}
+
+bool areWidgetStatesRelocatable(WidgetState *first, WidgetState *last) {
+    for (auto state = (uint8_t *)first; state < (uint8_t *)last; state += g_widgetStateSizes[((WidgetState *)state)->type]) {
+        if (!isRelocatableWidgetState(((WidgetState *)state)->type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void scrollWidgetStates(WidgetState *first, WidgetState *last, int shift, int dx, int dy) {
+    auto begin = (uint8_t *)first;
+    auto end = (uint8_t *)last;
+    int size = end - begin;
+
+    std::rotate(begin, shift > 0 ? begin + shift : end + shift, end);
+
+    auto movedBegin = shift > 0 ? begin : begin - shift;
+    auto movedEnd = shift > 0 ? end - shift : end;
+
+    for (auto state = movedBegin; state < movedEnd; state += g_widgetStateSizes[((WidgetState *)state)->type]) {
+        ((WidgetState *)state)->x += dx;
+        ((WidgetState *)state)->y += dy;
+    }
+
+    // follow g_foundWidgetAtDown, invalidate it if it was scrolled out
+	auto &widgetCursor = getFoundWidgetAtDown();
+    auto foundState = (uint8_t *)widgetCursor.currentState;
+    if (foundState >= begin && foundState < end) {
+        foundState = begin + (foundState - begin - shift + size) % size;
+        widgetCursor.currentState = (WidgetState *)foundState;
+        if (foundState >= movedBegin && foundState < movedEnd) {
+            widgetCursor.x += dx;
+            widgetCursor.y += dy;
+        } else {
+            g_foundWidgetAtDownInvalid = true;
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void forEachWidget(EnumWidgetsCallback callback) {
@@ -265,6 +265,15 @@ void enumNoneWidget();
 extern bool g_foundWidgetAtDownInvalid;
 void freeWidgetStates(WidgetState *topWidgetState);
 
+// Reorders item states of a scrolled List or Grid in place. States in [first, last)
+// are rotated by shift bytes, to the left if shift is positive and to the right if
+// negative, so states of items that stay visible land in their new slots and get
+// their position moved by (dx, dy). States rotated in at the other end are reused
+// for the newly exposed items. States are moved as raw bytes, so this may only be
+// called if areWidgetStatesRelocatable(first, last) returned true.
+void scrollWidgetStates(WidgetState *first, WidgetState *last, int shift, int dx, int dy);
+bool areWidgetStatesRelocatable(WidgetState *first, WidgetState *last);
+
 typedef void (*EnumWidgetsCallback)();
 extern EnumWidgetsCallback g_findCallback;
 void forEachWidget(EnumWidgetsCallback callback);
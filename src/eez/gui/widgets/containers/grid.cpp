@@ -32,17 +32,102 @@ namespace gui {
 bool GridWidgetState::updateState() {
     WIDGET_STATE_START(GridWidget);
 
-    startPosition = ytDataGetPosition(widgetCursor, widget->data);
-    count = eez::gui::count(widgetCursor, widget->data);
+    int newStartPosition = ytDataGetPosition(widgetCursor, widget->data);
+    auto newCount = eez::gui::count(widgetCursor, widget->data);
+
+    scrollDelta = hasPreviousState && newCount == count ? newStartPosition - startPosition : 0;
+
+    startPosition = newStartPosition;
+    count = newCount;
 
     WIDGET_STATE_END()
 }
 
+// After scrolling by whole rows (or columns) moves the pixels and the states of
+// the items that stay visible, so only the newly exposed items have to be
+// rendered. Returns false if all the items must be enumerated as usual.
+bool GridWidgetState::scrollItems(int &movedBegin, int &movedEnd) {
+    WidgetCursor &widgetCursor = g_widgetCursor;
+
+    int delta = scrollDelta;
+    scrollDelta = 0;
+
+    if (delta == 0 || g_findCallback || widgetCursor.refreshed || !widgetCursor.hasPreviousState || itemStateSize == 0) {
+        return false;
+    }
+
+    auto widget = (const GridWidget *)widgetCursor.widget;
+    if ((widget->visible && !isVisible.toBool()) || widgetCursor.opacity == 0) {
+        return false;
+    }
+
+    auto childWidget = static_cast<const Widget *>(widget->itemWidget);
+    if (childWidget->width <= 0 || childWidget->height <= 0) {
+        return false;
+    }
+
+    int numColumns = MAX(widgetCursor.w / childWidget->width, 1);
+    int numRows = MAX(widgetCursor.h / childWidget->height, 1);
+
+    bool rowFlow = widget->gridFlow == GRID_FLOW_ROW;
+    int lineLength = rowFlow ? numColumns : numRows;
+    int numLines = rowFlow ? numRows : numColumns;
+
+    // every cell must show an item before and after scrolling
+    int numCells = numColumns * numRows;
+    int numScrolled = delta > 0 ? delta : -delta;
+    if (
+        delta % lineLength != 0 || numScrolled >= numCells ||
+        numItemStates != numCells || startPosition < 0 || startPosition + numCells > count
+    ) {
+        return false;
+    }
+
+    auto firstItemState = widgetCursor.currentState;
+    auto lastItemState = (WidgetState *)((uint8_t *)firstItemState + numCells * itemStateSize);
+    if (lastItemState > g_widgetStateEnd || !areWidgetStatesRelocatable(firstItemState, lastItemState)) {
+        return false;
+    }
+
+    int deltaLines = delta / lineLength;
+    int numMovedLines = numLines - numScrolled / lineLength;
+
+    bool moved;
+    int shift;
+    if (rowFlow) {
+        shift = -deltaLines * childWidget->height;
+        int from = deltaLines > 0 ? deltaLines * childWidget->height : 0;
+        moved = moveRect(widgetCursor.x, widgetCursor.y + from, numColumns * childWidget->width, numMovedLines * childWidget->height, 0, shift);
+    } else {
+        shift = -deltaLines * childWidget->width;
+        int from = deltaLines > 0 ? deltaLines * childWidget->width : 0;
+        moved = moveRect(widgetCursor.x + from, widgetCursor.y, numMovedLines * childWidget->width, numRows * childWidget->height, shift, 0);
+    }
+    if (!moved) {
+        return false;
+    }
+
+    scrollWidgetStates(firstItemState, lastItemState, delta * itemStateSize, rowFlow ? 0 : shift, rowFlow ? shift : 0);
+
+    movedBegin = delta > 0 ? 0 : numScrolled;
+    movedEnd = movedBegin + numMovedLines * lineLength;
+
+    return true;
+}
+
 void GridWidgetState::enumChildren() {
     WidgetCursor &widgetCursor = g_widgetCursor;
 
+    int movedBegin = 0;
+    int movedEnd = 0;
+    bool scrolled = scrollItems(movedBegin, movedEnd);
+
+    numItemStates = 0;
+    itemStateSize = 0;
+
     if (count > 0) {
         auto widget = (const GridWidget *)widgetCursor.widget;
+        const Style *style = getStyle(widget->style);
 
         const Widget *childWidget = static_cast<const Widget *>(widget->itemWidget);
 		widgetCursor.widget = childWidget;
@@ -51,6 +136,7 @@ void GridWidgetState::enumChildren() {
         auto savedY = widgetCursor.y;
 
         auto savedCursor = widgetCursor.cursor;
+        auto savedRefreshed = widgetCursor.refreshed;
 
         int xOffset = 0;
         int yOffset = 0;
@@ -60,7 +146,7 @@ void GridWidgetState::enumChildren() {
         auto width = widgetCursor.w;
         auto height = widgetCursor.h;
 
-        for (int index = startPosition; index < count; ++index) {
+        for (int index = startPosition, slot = 0; index < count; ++index, ++slot) {
             select(widgetCursor, widget->data, index, oldValue);
 
 			widgetCursor.x = savedX + xOffset;
@@ -68,10 +154,27 @@ void GridWidgetState::enumChildren() {
             widgetCursor.w = childWidget->width;
             widgetCursor.h = childWidget->height;
 
+            auto itemState = widgetCursor.currentState;
+
+            if (scrolled && (slot < movedBegin || slot >= movedEnd)) {
+                // clear the pixels left by the scrolled out item
+                drawRectangle(widgetCursor.x, widgetCursor.y, widgetCursor.w, widgetCursor.h, style, false, false, true);
+                widgetCursor.refreshed = true;
+            }
+
 			widgetCursor.pushIterator(index);
             enumWidget();
 			widgetCursor.popIterator();
 
+            widgetCursor.refreshed = savedRefreshed;
+
+            int stateSize = (uint8_t *)widgetCursor.currentState - (uint8_t *)itemState;
+            if (numItemStates++ == 0) {
+                itemStateSize = stateSize;
+            } else if (stateSize != itemStateSize) {
+                itemStateSize = 0;
+            }
+
             if (widget->gridFlow == GRID_FLOW_ROW) {
                 xOffset += childWidget->width;
 
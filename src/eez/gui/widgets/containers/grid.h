@@ -30,8 +30,19 @@ struct GridWidgetState : public WidgetState {
     int startPosition;
     int count;
 
+    // set by updateState when the grid was scrolled, consumed by enumChildren
+    int scrollDelta;
+
+    // item states layout from the last enumChildren, itemStateSize is 0 if
+    // the items didn't have states of the same size
+    int numItemStates;
+    int itemStateSize;
+
     bool updateState() override;
     void enumChildren() override;
+
+private:
+    bool scrollItems(int &movedBegin, int &movedEnd);
 };
 
 } // namespace gui
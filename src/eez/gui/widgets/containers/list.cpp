@@ -33,11 +33,14 @@ bool ListWidgetState::updateState() {
     WIDGET_STATE_START(ListWidget);
 
     auto newStartPosition = ytDataGetPosition(widgetCursor, widget->data);
+    auto newCount = eez::gui::count(widgetCursor, widget->data);
+
+    scrollDelta = hasPreviousState && newCount == count ? (int)newStartPosition - startPosition : 0;
+
     if ((int)newStartPosition != startPosition) {
         startPosition = newStartPosition;
         hasPreviousState = false;
     }
-    auto newCount = eez::gui::count(widgetCursor, widget->data);
     if (newCount != count) {
         count = newCount;
         hasPreviousState = false;
@@ -46,9 +49,107 @@ bool ListWidgetState::updateState() {
     WIDGET_STATE_END()
 }
 
+// After scrolling by a few positions moves the pixels and the states of the
+// items that stay visible, so only the newly exposed items have to be rendered.
+// Returns false if all the items must be enumerated as usual.
+bool ListWidgetState::scrollItems(int &movedBegin, int &movedEnd) {
+    WidgetCursor &widgetCursor = g_widgetCursor;
+
+    int delta = scrollDelta;
+    scrollDelta = 0;
+
+    if (delta == 0 || g_findCallback || widgetCursor.refreshed || !widgetCursor.hasPreviousState || itemStateSize == 0) {
+        return false;
+    }
+
+    auto widget = (const ListWidget *)widgetCursor.widget;
+    if ((widget->visible && !isVisible.toBool()) || widgetCursor.opacity == 0) {
+        return false;
+    }
+
+    auto childWidget = static_cast<const Widget *>(widget->itemWidget);
+
+    bool vertical = widget->listType == LIST_TYPE_VERTICAL;
+    int itemSize = vertical ? childWidget->height : childWidget->width;
+    int size = vertical ? widgetCursor.h : widgetCursor.w;
+    int pitch = itemSize + widget->gap;
+    if (pitch <= 0) {
+        return false;
+    }
+
+    // every slot must show an item before and after scrolling
+    int numSlots = (size + pitch - 1) / pitch;
+    int numScrolled = delta > 0 ? delta : -delta;
+    if (numItemStates != numSlots || startPosition < 0 || startPosition + numSlots > count || numScrolled >= numSlots) {
+        return false;
+    }
+
+    auto firstItemState = widgetCursor.currentState;
+    auto lastItemState = (WidgetState *)((uint8_t *)firstItemState + numSlots * itemStateSize);
+    if (lastItemState > g_widgetStateEnd || !areWidgetStatesRelocatable(firstItemState, lastItemState)) {
+        return false;
+    }
+
+    // only items completely inside the list are moved, others are rendered again
+    int numFullSlots = size >= itemSize ? (size - itemSize) / pitch + 1 : 0;
+    int numMoved = numFullSlots - numScrolled;
+    if (numMoved <= 0) {
+        return false;
+    }
+
+    int from = delta > 0 ? delta * pitch : 0;
+    int length = numMoved * pitch - widget->gap;
+    int shift = -delta * pitch;
+
+    bool moved = vertical ?
+        moveRect(widgetCursor.x, widgetCursor.y + from, widgetCursor.w, length, 0, shift) :
+        moveRect(widgetCursor.x + from, widgetCursor.y, length, widgetCursor.h, shift, 0);
+    if (!moved) {
+        return false;
+    }
+
+    scrollWidgetStates(firstItemState, lastItemState, delta * itemStateSize, vertical ? 0 : shift, vertical ? shift : 0);
+
+    movedBegin = delta > 0 ? 0 : numScrolled;
+    movedEnd = movedBegin + numMoved;
+
+    return true;
+}
+
+void ListWidgetState::enumItem(int index, bool refresh) {
+    WidgetCursor &widgetCursor = g_widgetCursor;
+
+    auto itemState = widgetCursor.currentState;
+
+    auto savedRefreshed = widgetCursor.refreshed;
+    if (refresh) {
+        widgetCursor.refreshed = true;
+    }
+
+    widgetCursor.pushIterator(index);
+    enumWidget();
+    widgetCursor.popIterator();
+
+    widgetCursor.refreshed = savedRefreshed;
+
+    int stateSize = (uint8_t *)widgetCursor.currentState - (uint8_t *)itemState;
+    if (numItemStates++ == 0) {
+        itemStateSize = stateSize;
+    } else if (stateSize != itemStateSize) {
+        itemStateSize = 0;
+    }
+}
+
 void ListWidgetState::enumChildren() {
     WidgetCursor &widgetCursor = g_widgetCursor;
 
+    int movedBegin = 0;
+    int movedEnd = 0;
+    bool scrolled = scrollItems(movedBegin, movedEnd);
+
+    numItemStates = 0;
+    itemStateSize = 0;
+
     auto widget = (const ListWidget *)widgetCursor.widget;
     const Style *style = getStyle(widget->style);
 
@@ -67,8 +168,10 @@ void ListWidgetState::enumChildren() {
     auto width = widgetCursor.w;
     auto height = widgetCursor.h;
 
-    for (int index = startPosition; ; ++index) {
+    for (int index = startPosition, slot = 0; ; ++index, ++slot) {
         if (index >= 0 && index < count) {
+            bool refresh = scrolled && (slot < movedBegin || slot >= movedEnd);
+
             select(widgetCursor, widget->data, index, oldValue);
 
             widgetCursor.w = childWidget->width;
@@ -77,9 +180,11 @@ void ListWidgetState::enumChildren() {
             if (widget->listType == LIST_TYPE_VERTICAL) {
                 if (offset < height) {
                     widgetCursor.y = savedY + offset;
-                    widgetCursor.pushIterator(index);
-                    enumWidget();
-                    widgetCursor.popIterator();
+                    if (refresh) {
+                        // clear the pixels left by the scrolled out item
+                        drawRectangle(widgetCursor.x, widgetCursor.y, widgetCursor.w, MIN(widgetCursor.h, height - offset), style, false, false, true);
+                    }
+                    enumItem(index, refresh);
                     offset += childWidget->height + widget->gap;
                 } else {
                     break;
@@ -87,9 +192,11 @@ void ListWidgetState::enumChildren() {
             } else {
                 if (offset < width) {
                     widgetCursor.x = savedX + offset;
-                    widgetCursor.pushIterator(index);
-                    enumWidget();
-                    widgetCursor.popIterator();
+                    if (refresh) {
+                        // clear the pixels left by the scrolled out item
+                        drawRectangle(widgetCursor.x, widgetCursor.y, MIN(widgetCursor.w, width - offset), widgetCursor.h, style, false, false, true);
+                    }
+                    enumItem(index, refresh);
                     offset += childWidget->width + widget->gap;
                 } else {
                     break;
@@ -31,8 +31,20 @@ struct ListWidgetState : public WidgetState {
     int startPosition;
     int count;
 
+    // set by updateState when the list was scrolled, consumed by enumChildren
+    int scrollDelta;
+
+    // item states layout from the last enumChildren, itemStateSize is 0 if
+    // the items didn't have states of the same size
+    int numItemStates;
+    int itemStateSize;
+
     bool updateState() override;
     void enumChildren() override;
+
+private:
+    bool scrollItems(int &movedBegin, int &movedEnd);
+    void enumItem(int index, bool refresh);
 };
 
 } // namespace gui
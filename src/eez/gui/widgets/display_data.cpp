@@ -43,60 +43,14 @@ int findStartOfUnit(char *text, int i) {
     return i;
 }
 
-bool DisplayDataWidgetState::updateState() {
-    WIDGET_STATE_START(DisplayDataWidget);
-
-    const Style *style = getStyle(overrideStyle(widgetCursor, widget->style));
-
-    WIDGET_STATE(flags.active, g_isActiveWidget);
-    WIDGET_STATE(flags.focused, isFocusWidget(widgetCursor));
-    WIDGET_STATE(flags.blinking, g_isBlinkTime && (styleIsBlink(style) || isBlinking(widgetCursor, widget->data)));
-
-    uint32_t refreshRate;
-    if (widgetCursor.flowState) {
-        refreshRate = get(widgetCursor, widget->refreshRate).toInt32(nullptr);
-    } else {
-        refreshRate = getTextRefreshRate(widgetCursor, widget->data);
-    }
-
-    bool refreshData = true;
-    auto newData = get(widgetCursor, widget->data);
-    auto currentTime = millis();
-    if (hasPreviousState && data != newData) {
-        if (refreshRate != 0 && currentTime - dataRefreshLastTime < refreshRate) {
-            refreshData = false;
-        }
-    }
-    if (refreshData) {
-        WIDGET_STATE(data, newData);
-        dataRefreshLastTime = currentTime;
-    }
-
-    WIDGET_STATE(color,                 flags.focused ? style->focusColor           : getColor(widgetCursor, widget->data, style));
-    WIDGET_STATE(backgroundColor,       flags.focused ? style->focusBackgroundColor : getBackgroundColor(widgetCursor, widget->data, style));
-    WIDGET_STATE(activeColor,           flags.focused ? style->focusBackgroundColor : getActiveColor(widgetCursor, widget->data, style));
-    WIDGET_STATE(activeBackgroundColor, flags.focused ? style->focusColor           : getActiveBackgroundColor(widgetCursor, widget->data, style));
-
-    bool cursorVisible = millis() % (2 * CONF_GUI_TEXT_CURSOR_BLINK_TIME_MS) < CONF_GUI_TEXT_CURSOR_BLINK_TIME_MS;
-    WIDGET_STATE(cursorPosition, cursorVisible ? getTextCursorPosition(widgetCursor, widget->data) : -1);
-
-    WIDGET_STATE(xScroll, getXScroll(widgetCursor));
-
-    WIDGET_STATE_END()
-}
-
-void DisplayDataWidgetState::render() {
-    const WidgetCursor &widgetCursor = g_widgetCursor;
-
-    auto widget = (const DisplayDataWidget *)widgetCursor.widget;
-    const Style *style = getStyle(overrideStyle(widgetCursor, widget->style));
-
-    char text[64];
-    data.toText(text, sizeof(text));
+// Returns the part of the formatted data shown for the widget's display option
+// and its length, text is the buffer used for formatting.
+static const char *formatText(const DisplayDataWidget *widget, const Value &data, char *text, int textSize, int &length) {
+    data.toText(text, textSize);
 
     char *start = text;
 
-    int length = -1;
+    length = -1;
 
     if (widget->displayOption != DISPLAY_OPTION_ALL) {
         if (data.getType() == VALUE_TYPE_FLOAT) {
@@ -114,7 +68,7 @@ void DisplayDataWidgetState::render() {
                     text[k] = 0;
                 }
                 else {
-                    stringCopy(text, sizeof(text), ".0");
+                    stringCopy(text, textSize, ".0");
                 }
             } else if (widget->displayOption == DISPLAY_OPTION_UNIT) {
                 int i = findStartOfUnit(text, 0);
@@ -144,6 +98,82 @@ void DisplayDataWidgetState::render() {
         }
     }
 
+    if (length == -1) {
+        length = strlen(start);
+    }
+
+    return start;
+}
+
+bool DisplayDataWidgetState::updateState() {
+    WIDGET_STATE_START(DisplayDataWidget);
+
+    auto currentTime = millis();
+
+    WIDGET_STATE(flags.active, g_isActiveWidget);
+    WIDGET_STATE(flags.focused, isFocusWidget(widgetCursor));
+
+    // Refresh rate throttles the evaluation of data, colors and blinking, in
+    // between the previous values are kept unless something else changed.
+    if (!hasPreviousState || refreshRate == 0 || currentTime - dataRefreshLastTime >= refreshRate) {
+        dataRefreshLastTime = currentTime;
+
+        if (widgetCursor.flowState) {
+            refreshRate = get(widgetCursor, widget->refreshRate).toInt32(nullptr);
+        } else {
+            refreshRate = getTextRefreshRate(widgetCursor, widget->data);
+        }
+
+        const Style *style = getStyle(overrideStyle(widgetCursor, widget->style));
+
+        canBlink = styleIsBlink(style) || isBlinking(widgetCursor, widget->data);
+
+        auto newData = get(widgetCursor, widget->data);
+        if (data != newData) {
+            textCached = false;
+        }
+        WIDGET_STATE(data, newData);
+
+        WIDGET_STATE(color,                 flags.focused ? style->focusColor           : getColor(widgetCursor, widget->data, style));
+        WIDGET_STATE(backgroundColor,       flags.focused ? style->focusBackgroundColor : getBackgroundColor(widgetCursor, widget->data, style));
+        WIDGET_STATE(activeColor,           flags.focused ? style->focusBackgroundColor : getActiveColor(widgetCursor, widget->data, style));
+        WIDGET_STATE(activeBackgroundColor, flags.focused ? style->focusColor           : getActiveBackgroundColor(widgetCursor, widget->data, style));
+    }
+
+    WIDGET_STATE(flags.blinking, g_isBlinkTime && canBlink);
+
+    bool cursorVisible = currentTime % (2 * CONF_GUI_TEXT_CURSOR_BLINK_TIME_MS) < CONF_GUI_TEXT_CURSOR_BLINK_TIME_MS;
+    WIDGET_STATE(cursorPosition, cursorVisible ? getTextCursorPosition(widgetCursor, widget->data) : -1);
+
+    WIDGET_STATE(xScroll, getXScroll(widgetCursor));
+
+    WIDGET_STATE_END()
+}
+
+void DisplayDataWidgetState::render() {
+    const WidgetCursor &widgetCursor = g_widgetCursor;
+
+    auto widget = (const DisplayDataWidget *)widgetCursor.widget;
+    const Style *style = getStyle(overrideStyle(widgetCursor, widget->style));
+
+    char buffer[64];
+    const char *start;
+    int length;
+
+    if (textCached && textDisplayOption == widget->displayOption) {
+        start = text;
+        length = textLength;
+    } else {
+        start = formatText(widget, data, buffer, sizeof(buffer), length);
+
+        textCached = length < EEZ_GUI_DISPLAY_DATA_TEXT_CACHE_SIZE;
+        if (textCached) {
+            memcpy(text, start, length);
+            textLength = length;
+            textDisplayOption = widget->displayOption;
+        }
+    }
+
     drawText(
         start, length,
         widgetCursor.x, widgetCursor.y, widgetCursor.w, widgetCursor.h,
@@ -31,6 +31,16 @@ struct DisplayDataWidgetState : public WidgetState {
     int16_t cursorPosition;
     uint8_t xScroll;
 
+    // evaluated together with data, at most once per refreshRate
+    uint32_t refreshRate;
+    bool canBlink;
+
+    // displayed part of the formatted data, valid until data changes
+    bool textCached;
+    uint8_t textDisplayOption;
+    uint16_t textLength;
+    char text[EEZ_GUI_DISPLAY_DATA_TEXT_CACHE_SIZE];
+
     bool updateState() override;
     void render() override;
 };
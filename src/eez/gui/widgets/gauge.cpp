@@ -132,56 +132,102 @@ void GaugeWidgetState::render() {
 	auto xCenter = widgetCursor.w / 2;
 	auto yCenter = widgetCursor.h - 8;
 
-	// clear background
-	setColor(isActive ? style->activeBackgroundColor : style->backgroundColor);
-	fillRect(widgetCursor.x, widgetCursor.y, widgetCursor.x + widgetCursor.w - 1, widgetCursor.y + widgetCursor.h - 1);
-
-	// init AGG
-	display::AggDrawing aggDrawing;
-	display::aggInit(aggDrawing);
-	auto &graphics = aggDrawing.graphics;
-
-	graphics.clipBox(widgetCursor.x, widgetCursor.y, widgetCursor.x + widgetCursor.w, widgetCursor.y + widgetCursor.h);
-	graphics.translate(widgetCursor.x, widgetCursor.y);
-
-	// draw frame
-	if (style->borderSizeLeft > 0) {
-		graphics.lineWidth(style->borderSizeLeft);
-		graphics.lineColor(COLOR_TO_R(colorBorder), COLOR_TO_G(colorBorder), COLOR_TO_B(colorBorder));
-		graphics.noFill();
-		graphics.roundedRect(
-			style->borderSizeLeft / 2.0,
-			style->borderSizeLeft / 2.0,
-            widgetCursor.w - style->borderSizeLeft,
-            widgetCursor.h - style->borderSizeLeft,
-			style->borderRadiusTLX, style->borderRadiusTLY, style->borderRadiusTRX, style->borderRadiusTRY,
-			style->borderRadiusBRX, style->borderRadiusBRY, style->borderRadiusBLX, style->borderRadiusBLY
-		);
-	}
-
 	static const int PADDING_HORZ = 56;
 	static const int TICK_LINE_LENGTH = 5;
 	static const int TICK_LINE_WIDTH = 1;
 	static const int TICK_TEXT_GAP = 1;
 	static const int THRESHOLD_LINE_WIDTH = 2;
 
-	// draw border
 	auto radBorderOuter = (widgetCursor.w - PADDING_HORZ) / 2;
 
 	auto BORDER_WIDTH = radBorderOuter / 3;
 	auto BAR_WIDTH = BORDER_WIDTH / 2;
 
 	auto radBorderInner = radBorderOuter - BORDER_WIDTH;
-	graphics.resetPath();
-	graphics.noFill();
-	graphics.lineColor(COLOR_TO_R(colorBorder), COLOR_TO_G(colorBorder), COLOR_TO_B(colorBorder));
-	graphics.lineWidth(1.5);
-	arcBar(graphics, xCenter, yCenter, radBorderOuter, radBorderInner, 0);
-	graphics.drawPath();
 
-	// draw bar
 	auto radBarOuter = (widgetCursor.w - PADDING_HORZ) / 2 - (BORDER_WIDTH - BAR_WIDTH) / 2;
 	auto radBarInner = radBarOuter - BAR_WIDTH;
+
+	auto backgroundColorIndex = isActive ? style->activeBackgroundColor : style->backgroundColor;
+	setColor(backgroundColorIndex);
+	auto colorBackground = getColor();
+
+	// Background, frame and border are drawn before everything else, so they are
+	// retained and restored instead of redrawn. With the transparent background
+	// whatever is underneath shows through, so it is not retained in that case.
+	bool retainStaticLayer = backgroundColorIndex != TRANSPARENT_COLOR_INDEX;
+
+	// everything the static layer depends on, except the widget size
+	struct {
+		uint16_t colorBackground;
+		uint16_t colorBorder;
+		int16_t borderSize;
+		int16_t borderRadius[8];
+	} staticLayerKey = {
+		colorBackground,
+		colorBorder,
+		style->borderSizeLeft,
+		{
+			style->borderRadiusTLX, style->borderRadiusTLY, style->borderRadiusTRX, style->borderRadiusTRY,
+			style->borderRadiusBRX, style->borderRadiusBRY, style->borderRadiusBLX, style->borderRadiusBLY
+		}
+	};
+	uint32_t key = crc32((const uint8_t *)&staticLayerKey, sizeof(staticLayerKey));
+
+	if (
+		!retainStaticLayer ||
+		!staticLayer.isValid(widgetCursor.w, widgetCursor.h, key) ||
+		!staticLayer.draw(widgetCursor.x, widgetCursor.y)
+	) {
+		// clear background
+		fillRect(widgetCursor.x, widgetCursor.y, widgetCursor.x + widgetCursor.w - 1, widgetCursor.y + widgetCursor.h - 1);
+
+		display::AggDrawing aggDrawing;
+		display::aggInit(aggDrawing);
+		auto &graphics = aggDrawing.graphics;
+
+		graphics.clipBox(widgetCursor.x, widgetCursor.y, widgetCursor.x + widgetCursor.w, widgetCursor.y + widgetCursor.h);
+		graphics.translate(widgetCursor.x, widgetCursor.y);
+
+		// draw frame
+		if (style->borderSizeLeft > 0) {
+			graphics.lineWidth(style->borderSizeLeft);
+			graphics.lineColor(COLOR_TO_R(colorBorder), COLOR_TO_G(colorBorder), COLOR_TO_B(colorBorder));
+			graphics.noFill();
+			graphics.roundedRect(
+				style->borderSizeLeft / 2.0,
+				style->borderSizeLeft / 2.0,
+				widgetCursor.w - style->borderSizeLeft,
+				widgetCursor.h - style->borderSizeLeft,
+				style->borderRadiusTLX, style->borderRadiusTLY, style->borderRadiusTRX, style->borderRadiusTRY,
+				style->borderRadiusBRX, style->borderRadiusBRY, style->borderRadiusBLX, style->borderRadiusBLY
+			);
+		}
+
+		// draw border
+		graphics.resetPath();
+		graphics.noFill();
+		graphics.lineColor(COLOR_TO_R(colorBorder), COLOR_TO_G(colorBorder), COLOR_TO_B(colorBorder));
+		graphics.lineWidth(1.5);
+		arcBar(graphics, xCenter, yCenter, radBorderOuter, radBorderInner, 0);
+		graphics.drawPath();
+
+		if (retainStaticLayer) {
+			staticLayer.capture(widgetCursor.x, widgetCursor.y, widgetCursor.w, widgetCursor.h, key);
+		} else {
+			staticLayer.invalidate();
+		}
+	}
+
+	// init AGG
+	display::AggDrawing aggDrawing;
+	display::aggInit(aggDrawing);
+	auto &graphics = aggDrawing.graphics;
+
+	graphics.clipBox(widgetCursor.x, widgetCursor.y, widgetCursor.x + widgetCursor.w, widgetCursor.y + widgetCursor.h);
+	graphics.translate(widgetCursor.x, widgetCursor.y);
+
+	// draw bar
 	auto angle = remap(value, min, 180.0f, max, 0.0f);
 	graphics.resetPath();
 	graphics.noLine();
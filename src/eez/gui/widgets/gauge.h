@@ -32,6 +32,9 @@ struct GaugeWidgetState : public WidgetState {
 	Value thresholdValue;
 	Value unitValue;
 
+	// background, frame and border
+	RetainedLayer staticLayer;
+
     bool updateState() override;
 	void render() override;
 };
@@ -156,33 +156,18 @@ void LineChartWidgetState::render() {
     chart.yAxis.valueType = AXIS_VALUE_TYPE_NUMBER;
 
     if (executionState->numPoints > 0) {
-        chart.xAxis.min = FLT_MAX;
-        chart.xAxis.max = -FLT_MAX;
-
-        chart.yAxis.min = FLT_MAX;
-        chart.yAxis.max = -FLT_MAX;
-
-        for (uint32_t i = 0; i < executionState->numPoints; i++) {
-            uint32_t pointIndex = (executionState->startPointIndex + i) % executionState->maxPoints;
-
-            Value xValue = executionState->getX(pointIndex);
-            auto x = xValue.toDouble(nullptr);
-            if (x < chart.xAxis.min) chart.xAxis.min = x;
-            if (x > chart.xAxis.max) chart.xAxis.max = x;
-            if (i == 0) {
-                chart.xAxis.valueType = xValue.getType() == VALUE_TYPE_DATE ? AXIS_VALUE_TYPE_DATE : AXIS_VALUE_TYPE_NUMBER;
-            }
-
-            if (widget->yAxisRangeOption == Y_AXIS_RANGE_OPTION_FLOATING) {
-                for (uint32_t lineIndex = 0; lineIndex < executionState->numLines; lineIndex++) {
-                    auto y = executionState->getY(pointIndex, lineIndex);
-                    if (y < chart.yAxis.min) chart.yAxis.min = y;
-                    if (y > chart.yAxis.max) chart.yAxis.max = y;
-                }
-            }
+        if (!executionState->getXRange(chart.xAxis.min, chart.xAxis.max)) {
+            chart.xAxis.min = 0;
+            chart.xAxis.max = 0;
         }
+        chart.xAxis.valueType = executionState->isXDate(executionState->startPointIndex) ? AXIS_VALUE_TYPE_DATE : AXIS_VALUE_TYPE_NUMBER;
 
-        if (widget->yAxisRangeOption == Y_AXIS_RANGE_OPTION_FIXED) {
+        if (widget->yAxisRangeOption == Y_AXIS_RANGE_OPTION_FLOATING) {
+            if (!executionState->getYRange(chart.yAxis.min, chart.yAxis.max)) {
+                chart.yAxis.min = 0;
+                chart.yAxis.max = 0;
+            }
+        } else {
             chart.yAxis.min = yAxisRangeFrom.toDouble();
             chart.yAxis.max = yAxisRangeTo.toDouble();
         }
@@ -563,8 +548,7 @@ void LineChartWidgetState::render() {
             for (uint32_t i = 0; i < executionState->numPoints; i++) {
                 uint32_t pointIndex = (executionState->startPointIndex + i) % executionState->maxPoints;
 
-                Value xValue = executionState->getX(pointIndex);
-                auto x = chart.xAxis.offset + xValue.toDouble(nullptr) * chart.xAxis.scale;
+                auto x = chart.xAxis.offset + executionState->getX(pointIndex) * chart.xAxis.scale;
 
                 auto y = chart.yAxis.offset + executionState->getY(pointIndex, lineIndex) * chart.yAxis.scale;
 
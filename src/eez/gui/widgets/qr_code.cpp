@@ -12,6 +12,9 @@
 
 #if EEZ_OPTION_GUI
 
+#include <string.h>
+
+#include <eez/core/alloc.h>
 #include <eez/core/util.h>
 
 #include <eez/gui/gui.h>
@@ -30,49 +33,122 @@ bool QRCodeWidgetState::updateState() {
     WIDGET_STATE_END()
 }
 
-uint8_t qrcode[qrcodegen_BUFFER_LEN_MAX];
-uint8_t tempBuffer[qrcodegen_BUFFER_LEN_MAX];
+static uint8_t g_qrcode[qrcodegen_BUFFER_LEN_MAX];
+static uint8_t g_tempBuffer[qrcodegen_BUFFER_LEN_MAX];
 
-void QRCodeWidgetState::render() {
-    const WidgetCursor &widgetCursor = g_widgetCursor;
+// Encoded QR code and its last rasterization, reused while the text, error
+// correction level, widget size and colors stay the same.
+struct QRCodeCacheEntry {
+    char *text;
+    uint32_t textHash;
+    uint16_t errorCorrection;
 
-    auto widget = (const QRCodeWidget *)widgetCursor.widget;
-    const Style *style = getStyle(widget->style);
+    uint8_t *qrcode;
 
-    // Make QR code
-    qrcodegen_Ecc errCorLvl;
-    if (widget->errorCorrection == 0) errCorLvl = qrcodegen_Ecc_LOW;
-    else if (widget->errorCorrection == 1) errCorLvl = qrcodegen_Ecc_MEDIUM;
-    else if (widget->errorCorrection == 2) errCorLvl = qrcodegen_Ecc_QUARTILE;
-    else errCorLvl = qrcodegen_Ecc_HIGH;
+    int width;
+    int height;
+    uint16_t color;
+    uint16_t backgroundColor;
+    void *pixels;
 
-	qrcodegen_encodeText(data.getString(), tempBuffer, qrcode, errCorLvl, qrcodegen_VERSION_MIN, qrcodegen_VERSION_MAX, qrcodegen_Mask_AUTO, true);
+    uint32_t lastUsed;
+};
 
-    display::setColor(style->backgroundColor);
-    display::fillRect(widgetCursor.x, widgetCursor.y, widgetCursor.x + widgetCursor.w - 1, widgetCursor.y + widgetCursor.h - 1);
+static QRCodeCacheEntry g_qrCodeCache[EEZ_GUI_QR_CODE_CACHE_SIZE];
+static uint32_t g_qrCodeCacheCounter;
 
-    int size = qrcodegen_getSize(qrcode);
-    int border = 1;
+static void freeBitmap(QRCodeCacheEntry &entry) {
+    eez::free(entry.pixels);
+    entry.pixels = nullptr;
+}
+
+static void freeEntry(QRCodeCacheEntry &entry) {
+    eez::free(entry.text);
+    entry.text = nullptr;
+    eez::free(entry.qrcode);
+    entry.qrcode = nullptr;
+    freeBitmap(entry);
+}
 
-    double sizePx = 1.0 * MIN(widgetCursor.w, widgetCursor.h) / (size + 2 * border);
+static qrcodegen_Ecc getErrorCorrectionLevel(uint16_t errorCorrection) {
+    if (errorCorrection == 0) return qrcodegen_Ecc_LOW;
+    if (errorCorrection == 1) return qrcodegen_Ecc_MEDIUM;
+    if (errorCorrection == 2) return qrcodegen_Ecc_QUARTILE;
+    return qrcodegen_Ecc_HIGH;
+}
+
+// Returns the cache entry for the text, encodes it on miss. The entry has
+// qrcode == nullptr if the text can't be encoded. Returns nullptr if there is
+// not enough memory for the entry.
+static QRCodeCacheEntry *getQRCode(const char *text, uint16_t errorCorrection) {
+    size_t textLength = strlen(text);
+    uint32_t textHash = crc32((const uint8_t *)text, textLength);
+
+    QRCodeCacheEntry *lruEntry = &g_qrCodeCache[0];
+    for (int i = 0; i < EEZ_GUI_QR_CODE_CACHE_SIZE; i++) {
+        auto &entry = g_qrCodeCache[i];
+        if (
+            entry.text &&
+            entry.textHash == textHash &&
+            entry.errorCorrection == errorCorrection &&
+            strcmp(entry.text, text) == 0
+        ) {
+            entry.lastUsed = ++g_qrCodeCacheCounter;
+            return &entry;
+        }
+        if (!entry.text) {
+            if (lruEntry->text) {
+                lruEntry = &entry;
+            }
+        } else if (lruEntry->text && entry.lastUsed < lruEntry->lastUsed) {
+            lruEntry = &entry;
+        }
+    }
+
+    auto &entry = *lruEntry;
+    freeEntry(entry);
+
+    entry.text = (char *)eez::alloc(textLength + 1, 0x3c7e0d15);
+    if (!entry.text) {
+        return nullptr;
+    }
+    memcpy(entry.text, text, textLength + 1);
+    entry.textHash = textHash;
+    entry.errorCorrection = errorCorrection;
+    entry.lastUsed = ++g_qrCodeCacheCounter;
+
+    if (qrcodegen_encodeText(text, g_tempBuffer, g_qrcode, getErrorCorrectionLevel(errorCorrection), qrcodegen_VERSION_MIN, qrcodegen_VERSION_MAX, qrcodegen_Mask_AUTO, true)) {
+        int size = qrcodegen_getSize(g_qrcode);
+        size_t qrcodeLength = (size * size + 7) / 8 + 1;
+        entry.qrcode = (uint8_t *)eez::alloc(qrcodeLength, 0x3c7e0d16);
+        if (!entry.qrcode) {
+            // don't remember the text as not encodable
+            freeEntry(entry);
+            return nullptr;
+        }
+        memcpy(entry.qrcode, g_qrcode, qrcodeLength);
+    }
+
+    return &entry;
+}
 
-    double xPadding = (widgetCursor.w - sizePx * size) / 2;
-    double yPadding = (widgetCursor.h - sizePx * size) / 2;
+static void drawModules(Agg2D &graphics, const uint8_t *qrcode, double x, double y, double w, double h, uint16_t color16) {
+    int size = qrcodegen_getSize(qrcode);
+    int border = 1;
 
-	display::AggDrawing aggDrawing;
-	display::aggInit(aggDrawing);
-	auto &graphics = aggDrawing.graphics;
+    double sizePx = 1.0 * MIN(w, h) / (size + 2 * border);
 
-    auto color16 = display::getColor16FromIndex(style->color);
+    double xPadding = (w - sizePx * size) / 2;
+    double yPadding = (h - sizePx * size) / 2;
 
     graphics.resetPath();
 
-    for (int y = 0; y < size; y++) {
-		for (int x = 0; x < size; x++) {
-            if (qrcodegen_getModule(qrcode, x, y)) {
+    for (int j = 0; j < size; j++) {
+		for (int i = 0; i < size; i++) {
+            if (qrcodegen_getModule(qrcode, i, j)) {
                 graphics.moveTo(
-                    widgetCursor.x + xPadding + x * sizePx,
-                    widgetCursor.y + yPadding + y * sizePx
+                    x + xPadding + i * sizePx,
+                    y + yPadding + j * sizePx
                 );
                 graphics.horLineRel(sizePx);
                 graphics.verLineRel(sizePx);
@@ -87,6 +163,83 @@ void QRCodeWidgetState::render() {
     graphics.drawPath();
 }
 
+// Rasterizes the QR code into an off-screen bitmap of the widget size.
+static bool rasterize(QRCodeCacheEntry &entry, int width, int height, uint16_t color16, uint16_t backgroundColor16) {
+    if (entry.pixels && entry.width == width && entry.height == height && entry.color == color16 && entry.backgroundColor == backgroundColor16) {
+        return true;
+    }
+
+    freeBitmap(entry);
+
+    entry.pixels = eez::alloc(width * height * DISPLAY_BPP / 8, 0x3c7e0d17);
+    if (!entry.pixels) {
+        return false;
+    }
+
+    entry.width = width;
+    entry.height = height;
+    entry.color = color16;
+    entry.backgroundColor = backgroundColor16;
+
+#if DISPLAY_BPP == 16
+    auto pixels = (uint16_t *)entry.pixels;
+    auto backgroundPixel = backgroundColor16;
+#else
+    auto pixels = (uint32_t *)entry.pixels;
+    auto backgroundPixel = display::color16to32(backgroundColor16);
+#endif
+    for (int i = 0; i < width * height; i++) {
+        pixels[i] = backgroundPixel;
+    }
+
+    display::AggDrawing aggDrawing;
+    aggDrawing.rbuf.attach((uint8_t *)entry.pixels, width, height, width * DISPLAY_BPP / 8);
+    aggDrawing.graphics.attach(aggDrawing.rbuf.buf(), aggDrawing.rbuf.width(), aggDrawing.rbuf.height(), aggDrawing.rbuf.stride());
+
+    drawModules(aggDrawing.graphics, entry.qrcode, 0, 0, width, height, color16);
+
+    return true;
+}
+
+void QRCodeWidgetState::render() {
+    const WidgetCursor &widgetCursor = g_widgetCursor;
+
+    auto widget = (const QRCodeWidget *)widgetCursor.widget;
+    const Style *style = getStyle(widget->style);
+
+    display::setColor(style->backgroundColor);
+    uint16_t backgroundColor16 = display::getColor();
+    uint16_t color16 = display::getColor16FromIndex(style->color);
+
+    const char *text = data.getString();
+    auto entry = getQRCode(text ? text : "", widget->errorCorrection);
+
+    if (entry && entry->qrcode && rasterize(*entry, widgetCursor.w, widgetCursor.h, color16, backgroundColor16)) {
+        Image image;
+        image.width = widgetCursor.w;
+        image.height = widgetCursor.h;
+        image.bpp = DISPLAY_BPP;
+        image.lineOffset = 0;
+        image.pixels = (uint8_t *)entry->pixels;
+        display::drawBitmap(&image, widgetCursor.x, widgetCursor.y);
+        return;
+    }
+
+    display::fillRect(widgetCursor.x, widgetCursor.y, widgetCursor.x + widgetCursor.w - 1, widgetCursor.y + widgetCursor.h - 1);
+
+    // not enough memory for the cache, draw directly
+    const uint8_t *qrcode = entry ? entry->qrcode : nullptr;
+    if (!entry && qrcodegen_encodeText(text ? text : "", g_tempBuffer, g_qrcode, getErrorCorrectionLevel(widget->errorCorrection), qrcodegen_VERSION_MIN, qrcodegen_VERSION_MAX, qrcodegen_Mask_AUTO, true)) {
+        qrcode = g_qrcode;
+    }
+
+    if (qrcode) {
+        display::AggDrawing aggDrawing;
+        display::aggInit(aggDrawing);
+        drawModules(aggDrawing.graphics, qrcode, widgetCursor.x, widgetCursor.y, widgetCursor.w, widgetCursor.h, color16);
+    }
+}
+
 } // namespace gui
 } // namespace eez
 
@@ -13,6 +13,7 @@
 #if EEZ_OPTION_GUI
 
 #include <stdio.h>
+#include <limits.h>
 
 #include <eez/core/util.h>
 #include <eez/core/sound.h>
@@ -28,6 +29,31 @@ static const float BOUNCE_FORCE = 0.1f;
 namespace eez {
 namespace gui {
 
+RollerWidgetState::~RollerWidgetState() {
+    eez::free(labels);
+}
+
+RollerLabel *RollerWidgetState::getLabel(const WidgetCursor &widgetCursor, int index, font::Font &font, font::Font &selectedFont) {
+    auto label = &labels[(unsigned)(index - minValue) % numLabels];
+    if (label->index == index) {
+        return label;
+    }
+
+    auto widget = (const RollerWidget *)widgetCursor.widget;
+
+    set(widgetCursor, widget->data, index);
+
+    Value textValue = get(widgetCursor, widget->text);
+    textValue.toText(label->text, sizeof(label->text));
+
+    label->index = index;
+    label->textLength = (uint16_t)strlen(label->text);
+    label->width = (int16_t)display::measureStr(label->text, label->textLength, font, 0);
+    label->selectedWidth = (int16_t)display::measureStr(label->text, label->textLength, selectedFont, 0);
+
+    return label;
+}
+
 bool RollerWidgetState::updateState() {
     WIDGET_STATE_START(RollerWidget);
 
@@ -143,9 +169,38 @@ void RollerWidgetState::render() {
 
     auto y = widgetCursor.y + (widgetCursor.h - textHeight) / 2 + (int)roundf(position);
 
+    if (textHeight <= 0) {
+        return;
+    }
+
+    // one more row than fits, because rows are partially visible while spinning
+    int numVisibleRows = widgetCursor.h / textHeight + 2;
+    if (!labels || numLabels != numVisibleRows) {
+        eez::free(labels);
+        labels = (RollerLabel *)eez::alloc(numVisibleRows * sizeof(RollerLabel), 0x3a6d5c81);
+        numLabels = labels ? numVisibleRows : 0;
+        for (int i = 0; i < numLabels; i++) {
+            labels[i].index = INT_MIN;
+        }
+    }
+
+    if (!isRunning) {
+        for (int i = 0; i < numLabels; i++) {
+            labels[i].index = INT_MIN;
+        }
+    }
+
+    // skip rows above the widget
+    int first = minValue;
+    if (y + textHeight <= widgetCursor.y) {
+        int numRowsAbove = (widgetCursor.y - y) / textHeight;
+        first += numRowsAbove;
+        y += numRowsAbove * textHeight;
+    }
+
 	display::setColor(unselectedValueStyle->color);
 
-    for (int i = minValue; i <= maxValue; i++, y += textHeight) {
+    for (int i = first; i <= maxValue; i++, y += textHeight) {
         if (y + textHeight <= widgetCursor.y) {
             continue;
         }
@@ -153,16 +208,24 @@ void RollerWidgetState::render() {
             break;
         }
 
-        set(widgetCursor, widget->data, i);
-
-        Value textValue = get(widgetCursor, widget->text);
-
-        char text[100];
-        textValue.toText(text, sizeof(text));
+        RollerLabel *label;
+        RollerLabel uncachedLabel;
+        if (numLabels > 0) {
+            label = getLabel(widgetCursor, i, fontUnselectedValue, fontSelectedValue);
+        } else {
+            set(widgetCursor, widget->data, i);
+            Value textValue = get(widgetCursor, widget->text);
+            textValue.toText(uncachedLabel.text, sizeof(uncachedLabel.text));
+            uncachedLabel.textLength = (uint16_t)strlen(uncachedLabel.text);
+            uncachedLabel.width = (int16_t)display::measureStr(uncachedLabel.text, uncachedLabel.textLength, fontUnselectedValue, 0);
+            uncachedLabel.selectedWidth = (int16_t)display::measureStr(uncachedLabel.text, uncachedLabel.textLength, fontSelectedValue, 0);
+            label = &uncachedLabel;
+        }
 
-		auto textLength = strlen(text);
+        const char *text = label->text;
+        auto textLength = label->textLength;
 
-		int textWidth = display::measureStr(text, textLength, fontUnselectedValue, 0);
+		int textWidth = label->width;
 		if (y < clip1_y2) {
 			display::drawStr(
 				text, textLength,
@@ -182,7 +245,7 @@ void RollerWidgetState::render() {
 		}
 
 		if (y + textHeight >= clip2_y1 || y < clip2_y2) {
-			int textWidth = display::measureStr(text, textLength, fontSelectedValue, 0);
+			int textWidth = label->selectedWidth;
 
 			display::setColor(selectedValueStyle->color);
 			display::drawStr(
@@ -22,7 +22,17 @@ struct RollerWidget : public Widget {
     uint16_t componentIndex;
 };
 
+struct RollerLabel {
+    int index;
+    int16_t width; // with unselected value font
+    int16_t selectedWidth; // with selected value font
+    uint16_t textLength;
+    char text[100];
+};
+
 struct RollerWidgetState : public WidgetState {
+    ~RollerWidgetState();
+
     Value data;
 
 	int minValue = 1;
@@ -40,6 +50,11 @@ struct RollerWidgetState : public WidgetState {
     int dragStartPosition = 0;
     int dragPosition = 0;
 
+    // Formatted labels of the visible rows, slot is index % numLabels. Labels are
+    // reused only while the roller is spinning, otherwise text is evaluated again.
+    RollerLabel *labels = nullptr;
+    int numLabels = 0;
+
     bool updateState() override;
     void render() override;
 
@@ -53,6 +68,8 @@ private:
     void applySnapForce();
     void applyEdgeForce();
     void applyForce(float force);
+
+    RollerLabel *getLabel(const WidgetCursor &widgetCursor, int index, font::Font &font, font::Font &selectedFont);
 };
 
 
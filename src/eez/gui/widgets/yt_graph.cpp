@@ -14,6 +14,7 @@
 
 #include <math.h>
 #include <limits.h>
+#include <string.h>
 
 #include <eez/core/util.h>
 
@@ -233,6 +234,10 @@ struct YTGraphStaticDrawHelper {
 
     Value::YtDataGetValueFunctionPointer ytDataGetValue;
 
+    // envelope of the current value, if the data provider has one
+    const YTGraphEnvelope *envelope;
+    uint32_t samplesPerColumn;
+
     int xLabels[MAX_NUM_OF_Y_VALUES];
     int yLabels[MAX_NUM_OF_Y_VALUES];
 
@@ -248,7 +253,9 @@ struct YTGraphStaticDrawHelper {
             min = INT_MIN;
         } else {
             float fMax;
-            float fMin = ytDataGetValue(position, m_valueIndex, &fMax);
+            float fMin = envelope ?
+                envelope->getColumnValue(position, samplesPerColumn, &fMax) :
+                ytDataGetValue(position, m_valueIndex, &fMax);
 
             if (isNaN(fMin)) {
                 max = INT_MIN;
@@ -353,6 +360,8 @@ struct YTGraphStaticDrawHelper {
             const Style* style = ytDataGetStyle(widgetCursor, widget->data, m_valueIndex);
             dataColor16 = display::getColor16FromIndex(style->color);
 
+            envelope = ytDataGetEnvelope(widgetCursor, widget->data, m_valueIndex, samplesPerColumn);
+
             getYValue(position > 0 ? position - 1 : 0, yPrevMin, yPrevMax);
 
             for (x = startX; x < endX; x++, position++) {
@@ -606,6 +615,163 @@ void YTGraphWidgetState::onTouch(const WidgetCursor &widgetCursor, Event &touchE
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+static inline void combineMinMax(YTGraphEnvelope::MinMax &a, const YTGraphEnvelope::MinMax &b) {
+    // NaN marks a gap in the trace, skip it unless the whole bucket is a gap
+    if (isNaN(a.min)) {
+        a = b;
+    } else if (!isNaN(b.min)) {
+        if (b.min < a.min) {
+            a.min = b.min;
+        }
+        if (b.max > a.max) {
+            a.max = b.max;
+        }
+    }
+}
+
+static inline size_t getNumBuckets(uint32_t numSamples, int level) {
+    return (size_t)(((uint64_t)numSamples + (1ull << level) - 1) >> level);
+}
+
+YTGraphEnvelope::~YTGraphEnvelope() {
+    eez::free(samples);
+}
+
+bool YTGraphEnvelope::init(uint32_t capacity_) {
+    eez::free(samples);
+    samples = nullptr;
+    numLevels = 0;
+    capacity = 0;
+    numSamples = 0;
+
+    if (capacity_ == 0) {
+        return false;
+    }
+
+    size_t size = capacity_ * sizeof(float);
+    int n = 1;
+    while (n < MAX_LEVELS && (capacity_ >> n) > 0) {
+        size += getNumBuckets(capacity_, n) * sizeof(MinMax);
+        n++;
+    }
+
+    samples = (float *)eez::alloc(size, 0x5a1d7e03);
+    if (!samples) {
+        return false;
+    }
+
+    auto p = (uint8_t *)(samples + capacity_);
+    levels[0] = nullptr;
+    for (int level = 1; level < n; level++) {
+        levels[level] = (MinMax *)p;
+        p += getNumBuckets(capacity_, level) * sizeof(MinMax);
+    }
+
+    numLevels = n;
+    capacity = capacity_;
+
+    return true;
+}
+
+uint32_t YTGraphEnvelope::append(const float *values, uint32_t count) {
+    if (count > capacity - numSamples) {
+        count = capacity - numSamples;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    uint32_t first = numSamples;
+    uint32_t last = numSamples + count - 1;
+
+    memcpy(samples + first, values, count * sizeof(float));
+    numSamples += count;
+
+    // only the buckets touched by the new samples are recomputed, each one from
+    // its (at most two) children in the level below
+    for (int level = 1; level < numLevels; level++) {
+        uint32_t firstBucket = first >> level;
+        uint32_t lastBucket = last >> level;
+        MinMax *dst = levels[level];
+
+        if (level == 1) {
+            for (uint32_t bucket = firstBucket; bucket <= lastBucket; bucket++) {
+                uint32_t i = 2 * bucket;
+                MinMax a = { samples[i], samples[i] };
+                if (i + 1 < numSamples) {
+                    MinMax b = { samples[i + 1], samples[i + 1] };
+                    combineMinMax(a, b);
+                }
+                dst[bucket] = a;
+            }
+        } else {
+            const MinMax *src = levels[level - 1];
+            for (uint32_t bucket = firstBucket; bucket <= lastBucket; bucket++) {
+                uint32_t i = 2 * bucket;
+                MinMax a = src[i];
+                if (((i + 1) << (level - 1)) < numSamples) {
+                    combineMinMax(a, src[i + 1]);
+                }
+                dst[bucket] = a;
+            }
+        }
+    }
+
+    return count;
+}
+
+bool YTGraphEnvelope::getMinMax(uint32_t start, uint32_t end, float &min, float &max) const {
+    if (end > numSamples) {
+        end = numSamples;
+    }
+    if (start >= end) {
+        return false;
+    }
+
+    MinMax result = { NAN, NAN };
+
+    // at each position take the largest bucket aligned to it that doesn't
+    // stick out of the range, so only samples inside the range are combined
+    for (uint32_t i = start; i < end; ) {
+        int level = 0;
+        while (level + 1 < numLevels && (i & ((2u << level) - 1)) == 0 && (uint64_t)i + (2ull << level) <= end) {
+            level++;
+        }
+
+        if (level == 0) {
+            MinMax b = { samples[i], samples[i] };
+            combineMinMax(result, b);
+            i++;
+        } else {
+            combineMinMax(result, levels[level][i >> level]);
+            i += 1u << level;
+        }
+    }
+
+    min = result.min;
+    max = result.max;
+
+    return true;
+}
+
+float YTGraphEnvelope::getColumnValue(uint32_t column, uint32_t samplesPerColumn, float *max) const {
+    uint64_t start = (uint64_t)column * samplesPerColumn;
+
+    if (!max) {
+        return start < numSamples ? samples[start] : NAN;
+    }
+
+    float min;
+    if (start >= numSamples || !getMinMax((uint32_t)start, (uint32_t)MIN(start + samplesPerColumn, (uint64_t)numSamples), min, *max)) {
+        *max = NAN;
+        return NAN;
+    }
+
+    return min;
+}
+
 } // namespace gui
 } // namespace eez
 
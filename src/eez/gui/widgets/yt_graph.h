@@ -49,5 +49,56 @@ struct YTGraphWidgetState : public WidgetState {
 	void onTouch(const WidgetCursor &widgetCursor, Event &touchEvent) override;
 };
 
+// Multi-resolution min/max envelope of one trace. Level l keeps the min and max
+// of every 2^l consecutive samples and is updated while samples are appended.
+// Data provider returns it for DATA_OPERATION_YT_DATA_GET_ENVELOPE and the
+// static YT graph then gets every pixel column from O(log samplesPerColumn)
+// buckets, without scanning all the samples covered by the column.
+struct YTGraphEnvelope {
+    static const int MAX_LEVELS = 32;
+
+    struct MinMax {
+        float min;
+        float max;
+    };
+
+    YTGraphEnvelope() {}
+    ~YTGraphEnvelope();
+
+    // owns the samples and the levels
+    YTGraphEnvelope(const YTGraphEnvelope &) = delete;
+    YTGraphEnvelope &operator=(const YTGraphEnvelope &) = delete;
+
+    bool init(uint32_t capacity);
+
+    void reset() { numSamples = 0; }
+
+    uint32_t getCapacity() const { return capacity; }
+    uint32_t getNumSamples() const { return numSamples; }
+    float getSample(uint32_t index) const { return samples[index]; }
+
+    // returns the number of appended samples, less than count if capacity is reached
+    uint32_t append(float value) { return append(&value, 1); }
+    uint32_t append(const float *values, uint32_t count);
+
+    // Exact min/max of the samples in [start, end), combined from the largest
+    // aligned buckets inside the range (O(log n) buckets).
+    bool getMinMax(uint32_t start, uint32_t end, float &min, float &max) const;
+
+    // Returns the min of the samples shown in the column and stores their max, or
+    // returns the first sample of the column if max is nullptr. Used by the static
+    // YT graph when the data provider returns the envelope (see ytDataGetEnvelope),
+    // a provider can also call it from its Value::YtDataGetValueFunctionPointer
+    // callback with the row index as the column.
+    float getColumnValue(uint32_t column, uint32_t samplesPerColumn, float *max) const;
+
+private:
+    float *samples = nullptr;
+    MinMax *levels[MAX_LEVELS];
+    int numLevels = 0;
+    uint32_t capacity = 0;
+    uint32_t numSamples = 0;
+};
+
 } // gui
 } // eez
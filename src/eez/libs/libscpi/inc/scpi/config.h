@@ -174,6 +174,27 @@ extern "C" {
 #define USE_UNITS_ELECTRIC_CHARGE_CONDUCTANCE SYSTEM_TYPE
 #endif
 
+/* Size of hash table of unit names in scpi_t, 0 = linear search.
+ * Costs 2 bytes per entry (plus a few bytes) in every scpi_t, e.g. 256 entries
+ * take about 520 bytes, so it is disabled by default. */
+#ifndef SCPI_UNITS_HASH_TABLE_SIZE
+#define SCPI_UNITS_HASH_TABLE_SIZE 0
+#endif
+
+/* Number of choice lists with precomputed name hashes in scpi_t, 0 = no cache.
+ * Choice lists are expected to be constant, like command patterns.
+ * Each cached list costs 10 bytes per SCPI_CHOICE_CACHE_MAX_OPTIONS (plus about
+ * 24 bytes) in every scpi_t, about 344 bytes for 32 options, so it is disabled
+ * by default. */
+#ifndef SCPI_CHOICE_CACHE_SIZE
+#define SCPI_CHOICE_CACHE_SIZE 0
+#endif
+
+/* Longer choice lists are not cached */
+#ifndef SCPI_CHOICE_CACHE_MAX_OPTIONS
+#define SCPI_CHOICE_CACHE_MAX_OPTIONS 32
+#endif
+
 /* define local macros depending on existance of strnlen */
 #if HAVE_STRNLEN
 #define SCPIDEFINE_strnlen(s, l)	strnlen((s), (l))
@@ -142,6 +142,8 @@ extern "C" {
     typedef size_t(*scpi_write_t)(scpi_t * context, const char * data, size_t len);
     typedef scpi_result_t(*scpi_write_control_t)(scpi_t * context, scpi_ctrl_name_t ctrl, scpi_reg_val_t val);
     typedef int (*scpi_error_callback_t)(scpi_t * context, int_fast16_t error);
+    typedef scpi_bool_t(*scpi_arbitrary_block_begin_t)(scpi_t * context, const char * message, size_t message_len, size_t block_len);
+    typedef void (*scpi_arbitrary_block_data_t)(scpi_t * context, const char * data, size_t len);
 
     /* scpi lexer */
     enum _scpi_token_type_t {
@@ -321,6 +323,30 @@ extern "C" {
 #define SCPI_CHOICE_LIST_END   {NULL, -1}
     typedef struct _scpi_choice_def_t scpi_choice_def_t;
 
+#if SCPI_UNITS_HASH_TABLE_SIZE > 0
+    struct _scpi_units_hash_table_t {
+        const scpi_unit_def_t * units; /* units the table is built for */
+        scpi_bool_t valid; /* FALSE if there are too many units */
+        uint16_t index[SCPI_UNITS_HASH_TABLE_SIZE]; /* unit index + 1, 0 = empty slot */
+    };
+    typedef struct _scpi_units_hash_table_t scpi_units_hash_table_t;
+#endif
+
+#if SCPI_CHOICE_CACHE_SIZE > 0
+    /* lengths and hashes of long and short form of choice names */
+    struct _scpi_choice_cache_t {
+        const scpi_choice_def_t * options;
+        const char * first_name;
+        uint32_t last_used;
+        uint8_t count;
+        uint8_t long_len[SCPI_CHOICE_CACHE_MAX_OPTIONS];
+        uint8_t short_len[SCPI_CHOICE_CACHE_MAX_OPTIONS];
+        uint32_t long_hash[SCPI_CHOICE_CACHE_MAX_OPTIONS];
+        uint32_t short_hash[SCPI_CHOICE_CACHE_MAX_OPTIONS];
+    };
+    typedef struct _scpi_choice_cache_t scpi_choice_cache_t;
+#endif
+
     struct _scpi_param_list_t {
         const scpi_command_t * cmd;
         lex_state_t lex_state;
@@ -362,8 +388,37 @@ extern "C" {
         scpi_write_control_t control;
         scpi_command_callback_t flush;
         scpi_command_callback_t reset;
+        /* optional, called by SCPI_Input when arbitrary block program data
+         * starts; return TRUE to receive the block data through
+         * arbitrary_block_data instead of the input buffer, the command then
+         * gets an empty block (#10) in place of the data */
+        scpi_arbitrary_block_begin_t arbitrary_block_begin;
+        scpi_arbitrary_block_data_t arbitrary_block_data;
     };
 
+    enum _scpi_input_framing_state_t {
+        SCPI_INPUT_FRAMING_PROGRAM = 0,
+        SCPI_INPUT_FRAMING_SKIP_LF,
+        SCPI_INPUT_FRAMING_SINGLE_QUOTE,
+        SCPI_INPUT_FRAMING_DOUBLE_QUOTE,
+        SCPI_INPUT_FRAMING_BLOCK_HASH,
+        SCPI_INPUT_FRAMING_BLOCK_LENGTH,
+        SCPI_INPUT_FRAMING_BLOCK_DATA,
+        SCPI_INPUT_FRAMING_BLOCK_STREAM
+    };
+    typedef enum _scpi_input_framing_state_t scpi_input_framing_state_t;
+
+    /* state of SCPI_Input between calls, so received data is scanned only once */
+    struct _scpi_input_framing_t {
+        scpi_input_framing_state_t state;
+        size_t start; /* start of the pending program message in the input buffer */
+        size_t scan; /* input buffer is scanned up to this position */
+        size_t block_start; /* position of '#' of the arbitrary block header */
+        size_t block_len; /* remaining arbitrary block data */
+        int block_digits; /* remaining digits of the arbitrary block length */
+    };
+    typedef struct _scpi_input_framing_t scpi_input_framing_t;
+
     struct _scpi_t {
         const scpi_command_t * cmdlist;
         scpi_buffer_t buffer;
@@ -382,6 +437,15 @@ extern "C" {
         scpi_parser_state_t parser_state;
         const char * idn[4];
         size_t arbitrary_reminding;
+        scpi_input_framing_t input_framing;
+        scpi_buffer_t output_buffer;
+#if SCPI_UNITS_HASH_TABLE_SIZE > 0
+        scpi_units_hash_table_t units_hash_table;
+#endif
+#if SCPI_CHOICE_CACHE_SIZE > 0
+        scpi_choice_cache_t choice_cache[SCPI_CHOICE_CACHE_SIZE];
+        uint32_t choice_cache_counter;
+#endif
     };
 
     enum _scpi_array_format_t {
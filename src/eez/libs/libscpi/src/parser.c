@@ -50,6 +50,36 @@
 #include "scpi/constants.h"
 #include "scpi/utils.h"
 
+/**
+ * Pass data collected in the output buffer to the interface
+ * @param context
+ */
+static void flushOutputBuffer(scpi_t * context) {
+    scpi_buffer_t * output = &context->output_buffer;
+    if (output->position > 0) {
+        context->interface->write(context, output->data, output->position);
+        output->position = 0;
+    }
+}
+
+/**
+ * Reserve space for len bytes at the end of the output buffer
+ * @param context
+ * @param len
+ * @return pointer to reserved space or NULL if there is no output buffer
+ * or it is too small
+ */
+static char * reserveOutputBuffer(scpi_t * context, size_t len) {
+    scpi_buffer_t * output = &context->output_buffer;
+    if (output->data == NULL || len > output->length) {
+        return NULL;
+    }
+    if (output->length - output->position < len) {
+        flushOutputBuffer(context);
+    }
+    return output->data + output->position;
+}
+
 /**
  * Write data to SCPI output
  * @param context
@@ -58,11 +88,25 @@
  * @return number of bytes written
  */
 static size_t writeData(scpi_t * context, const char * data, size_t len) {
-    if (len > 0) {
-        return context->interface->write(context, data, len);
-    } else {
+    scpi_buffer_t * output = &context->output_buffer;
+    char * ptr;
+
+    if (len == 0) {
         return 0;
     }
+
+    ptr = reserveOutputBuffer(context, len);
+    if (ptr != NULL) {
+        memcpy(ptr, data, len);
+        output->position += len;
+        return len;
+    }
+
+    /* no output buffer or data is larger than the whole buffer */
+    if (output->data != NULL) {
+        flushOutputBuffer(context);
+    }
+    return context->interface->write(context, data, len);
 }
 
 /**
@@ -103,6 +147,7 @@ static size_t writeNewLine(scpi_t * context) {
 #error no termination character defined
 #endif
         len = writeData(context, SCPI_LINE_ENDING, strlen(SCPI_LINE_ENDING));
+        flushOutputBuffer(context);
         flushData(context);
         return len;
     } else {
@@ -245,6 +290,9 @@ scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len) {
     /* conditionaly write new line */
     writeNewLine(context);
 
+    /* response without new line, e.g. incomplete arbitrary block */
+    flushOutputBuffer(context);
+
     return result;
 }
 
@@ -299,56 +347,258 @@ void SCPI_InitHeap(scpi_t * context,
 }
 #endif
 
+/**
+ * Set buffer where the response is collected before it is passed to the
+ * interface write callback. Without it every part of the response (value,
+ * delimiter, quote, new line) is written separately.
+ * @param context
+ * @param output_buffer
+ * @param output_buffer_length
+ */
+void SCPI_InitOutputBuffer(scpi_t * context, char * output_buffer, size_t output_buffer_length) {
+    context->output_buffer.data = output_buffer;
+    context->output_buffer.length = output_buffer_length;
+    context->output_buffer.position = 0;
+}
+
+/**
+ * Parse pending program message, from its start up to the scan position
+ * @param context
+ * @return
+ */
+static scpi_bool_t parsePendingMessage(scpi_t * context) {
+    scpi_input_framing_t * framing = &context->input_framing;
+    scpi_bool_t result;
+
+    result = SCPI_Parse(context, context->buffer.data + framing->start, framing->scan - framing->start);
+    framing->start = framing->scan;
+
+    return result;
+}
+
+/**
+ * Arbitrary block header is scanned, offer the block data to the application
+ * @param context
+ */
+static void beginArbitraryBlock(scpi_t * context) {
+    scpi_input_framing_t * framing = &context->input_framing;
+    scpi_buffer_t * buffer = &context->buffer;
+    scpi_interface_t * interface = context->interface;
+    size_t len;
+    size_t rest;
+
+    if (framing->block_len == 0) {
+        framing->state = SCPI_INPUT_FRAMING_PROGRAM;
+        return;
+    }
+
+    framing->state = SCPI_INPUT_FRAMING_BLOCK_DATA;
+
+    if (!interface || !interface->arbitrary_block_begin || !interface->arbitrary_block_data) {
+        return;
+    }
+
+    if (!interface->arbitrary_block_begin(context, buffer->data + framing->start, framing->block_start - framing->start, framing->block_len)) {
+        return;
+    }
+
+    /* header is at least 3 characters long, replace it with an empty block */
+    memcpy(buffer->data + framing->block_start, "#10", 3);
+
+    /* pass block data already in the buffer */
+    len = buffer->position - framing->scan;
+    if (len > framing->block_len) {
+        len = framing->block_len;
+    }
+    if (len > 0) {
+        interface->arbitrary_block_data(context, buffer->data + framing->scan, len);
+        framing->block_len -= len;
+    }
+
+    /* and keep what follows the block */
+    rest = buffer->position - framing->scan - len;
+    memmove(buffer->data + framing->block_start + 3, buffer->data + framing->scan + len, rest);
+    framing->scan = framing->block_start + 3;
+    buffer->position = framing->scan + rest;
+    buffer->data[buffer->position] = 0;
+
+    framing->state = framing->block_len > 0 ? SCPI_INPUT_FRAMING_BLOCK_STREAM : SCPI_INPUT_FRAMING_PROGRAM;
+}
+
+/**
+ * Scan input buffer from the last scan position and parse all complete
+ * program messages. Arbitrary block data and quoted strings are skipped, so
+ * <CR> and <LF> inside them are not taken as message termination.
+ * @param context
+ * @return FALSE if there was some error during evaluation of commands
+ */
+static scpi_bool_t scanInput(scpi_t * context) {
+    scpi_input_framing_t * framing = &context->input_framing;
+    scpi_buffer_t * buffer = &context->buffer;
+    scpi_bool_t result = TRUE;
+    size_t len;
+    char c;
+
+    while (framing->scan < buffer->position && framing->state != SCPI_INPUT_FRAMING_BLOCK_STREAM) {
+        c = buffer->data[framing->scan];
+
+        switch (framing->state) {
+            case SCPI_INPUT_FRAMING_BLOCK_DATA:
+                len = buffer->position - framing->scan;
+                if (len > framing->block_len) {
+                    len = framing->block_len;
+                }
+                framing->scan += len;
+                framing->block_len -= len;
+                if (framing->block_len == 0) {
+                    framing->state = SCPI_INPUT_FRAMING_PROGRAM;
+                }
+                break;
+
+            case SCPI_INPUT_FRAMING_SKIP_LF:
+                /* <CR><LF> is one termination */
+                framing->state = SCPI_INPUT_FRAMING_PROGRAM;
+                if (c == '\n') {
+                    framing->scan++;
+                    framing->start = framing->scan;
+                }
+                break;
+
+            case SCPI_INPUT_FRAMING_SINGLE_QUOTE:
+            case SCPI_INPUT_FRAMING_DOUBLE_QUOTE:
+                /* <CR> and <LF> are string content, only the closing quote ends the string */
+                if (c == (framing->state == SCPI_INPUT_FRAMING_SINGLE_QUOTE ? '\'' : '"')) {
+                    framing->state = SCPI_INPUT_FRAMING_PROGRAM;
+                }
+                framing->scan++;
+                break;
+
+            case SCPI_INPUT_FRAMING_BLOCK_HASH:
+                if (c >= '1' && c <= '9') {
+                    framing->block_digits = c - '0';
+                    framing->block_len = 0;
+                    framing->state = SCPI_INPUT_FRAMING_BLOCK_LENGTH;
+                    framing->scan++;
+                } else {
+                    /* not an arbitrary block, e.g. #H1F */
+                    framing->state = SCPI_INPUT_FRAMING_PROGRAM;
+                }
+                break;
+
+            case SCPI_INPUT_FRAMING_BLOCK_LENGTH:
+                if (isdigit((uint8_t) c)) {
+                    framing->block_len = framing->block_len * 10 + (c - '0');
+                    framing->scan++;
+                    if (--framing->block_digits == 0) {
+                        beginArbitraryBlock(context);
+                    }
+                } else {
+                    /* invalid header, let the parser report it */
+                    framing->state = SCPI_INPUT_FRAMING_PROGRAM;
+                }
+                break;
+
+            default:
+                framing->scan++;
+                if (c == '\n') {
+                    result &= parsePendingMessage(context);
+                } else if (c == '\r') {
+                    result &= parsePendingMessage(context);
+                    framing->state = SCPI_INPUT_FRAMING_SKIP_LF;
+                } else if (c == '\'') {
+                    framing->state = SCPI_INPUT_FRAMING_SINGLE_QUOTE;
+                } else if (c == '"') {
+                    framing->state = SCPI_INPUT_FRAMING_DOUBLE_QUOTE;
+                } else if (c == '#') {
+                    framing->block_start = framing->scan - 1;
+                    framing->state = SCPI_INPUT_FRAMING_BLOCK_HASH;
+                }
+                break;
+        }
+    }
+
+    if (framing->start == buffer->position) {
+        /* everything is consumed, start again from the beginning of the buffer */
+        framing->start = framing->scan = buffer->position = 0;
+        buffer->data[0] = 0;
+    }
+
+    return result;
+}
+
 /**
  * Interface to the application. Adds data to system buffer and try to search
  * command line termination. If the termination is found or if len=0, command
  * parser is called.
  *
+ * Data is scanned only once: the scan position and framing state are kept
+ * between calls and the consumed messages are removed from the buffer only
+ * when there is no room for new data.
+ *
  * @param context
  * @param data - data to process
  * @param len - length of data
  * @return
  */
 scpi_bool_t SCPI_Input(scpi_t * context, const char * data, int len) {
+    scpi_input_framing_t * framing = &context->input_framing;
+    scpi_buffer_t * buffer = &context->buffer;
     scpi_bool_t result = TRUE;
-    size_t totcmdlen = 0;
-    int cmdlen = 0;
+    size_t buffer_free;
+    size_t n;
 
     if (len == 0) {
-        context->buffer.data[context->buffer.position] = 0;
-        result = SCPI_Parse(context, context->buffer.data, context->buffer.position);
-        context->buffer.position = 0;
-    } else {
-        int buffer_free;
+        buffer->data[buffer->position] = 0;
+        result = SCPI_Parse(context, buffer->data + framing->start, buffer->position - framing->start);
+        buffer->position = 0;
+        memset(framing, 0, sizeof (*framing));
+        return result;
+    }
+
+    while (len > 0) {
+        if (framing->state == SCPI_INPUT_FRAMING_BLOCK_STREAM) {
+            /* arbitrary block data goes directly to the application */
+            n = (size_t) len < framing->block_len ? (size_t) len : framing->block_len;
+            context->interface->arbitrary_block_data(context, data, n);
+            framing->block_len -= n;
+            if (framing->block_len == 0) {
+                framing->state = SCPI_INPUT_FRAMING_PROGRAM;
+            }
+            data += n;
+            len -= n;
+            continue;
+        }
+
+        buffer_free = buffer->length - 1 - buffer->position;
+        if (buffer_free < (size_t) len && framing->start > 0) {
+            /* move pending message to the beginning of the buffer */
+            memmove(buffer->data, buffer->data + framing->start, buffer->position - framing->start);
+            buffer->position -= framing->start;
+            framing->scan -= framing->start;
+            if (framing->block_start >= framing->start) {
+                framing->block_start -= framing->start;
+            }
+            framing->start = 0;
+            buffer_free = buffer->length - 1 - buffer->position;
+        }
 
-        buffer_free = context->buffer.length - context->buffer.position;
-        if (len > (buffer_free - 1)) {
+        if (buffer_free == 0) {
             /* Input buffer overrun - invalidate buffer */
-            context->buffer.position = 0;
-            context->buffer.data[context->buffer.position] = 0;
+            buffer->position = 0;
+            buffer->data[buffer->position] = 0;
+            memset(framing, 0, sizeof (*framing));
             SCPI_ErrorPush(context, SCPI_ERROR_INPUT_BUFFER_OVERRUN);
             return FALSE;
         }
-        memcpy(&context->buffer.data[context->buffer.position], data, len);
-        context->buffer.position += len;
-        context->buffer.data[context->buffer.position] = 0;
 
+        n = (size_t) len < buffer_free ? (size_t) len : buffer_free;
+        memcpy(buffer->data + buffer->position, data, n);
+        buffer->position += n;
+        buffer->data[buffer->position] = 0;
+        data += n;
+        len -= n;
 
-        while (1) {
-            cmdlen = scpiParser_detectProgramMessageUnit(&context->parser_state, context->buffer.data + totcmdlen, context->buffer.position - totcmdlen);
-            totcmdlen += cmdlen;
-
-            if (context->parser_state.termination == SCPI_MESSAGE_TERMINATION_NL) {
-                result = SCPI_Parse(context, context->buffer.data, totcmdlen);
-                memmove(context->buffer.data, context->buffer.data + totcmdlen, context->buffer.position - totcmdlen);
-                context->buffer.position -= totcmdlen;
-                totcmdlen = 0;
-            } else {
-                if (context->parser_state.programHeader.type == SCPI_TOKEN_UNKNOWN
-                        && context->parser_state.termination == SCPI_MESSAGE_TERMINATION_NONE) break;
-                if (totcmdlen >= context->buffer.position) break;
-            }
-        }
+        result &= scanInput(context);
     }
 
     return result;
@@ -1220,6 +1470,60 @@ scpi_bool_t SCPI_ParamCopyText(scpi_t * context, char * buffer, size_t buffer_le
     return result;
 }
 
+#if SCPI_CHOICE_CACHE_SIZE > 0
+/**
+ * Find or create precomputed lengths and hashes of the choice names
+ * @param context
+ * @param options
+ * @return NULL if the list can't be cached
+ */
+static const scpi_choice_cache_t * getChoiceCache(scpi_t * context, const scpi_choice_def_t * options) {
+    scpi_choice_cache_t * cache = NULL;
+    size_t i;
+    size_t len;
+    size_t short_len;
+
+    for (i = 0; i < SCPI_CHOICE_CACHE_SIZE; i++) {
+        scpi_choice_cache_t * entry = &context->choice_cache[i];
+        if (entry->options == options && entry->first_name == options[0].name && options[entry->count].name == NULL) {
+            entry->last_used = ++context->choice_cache_counter;
+            return entry;
+        }
+
+        if (!cache || (cache->options && (!entry->options || entry->last_used < cache->last_used))) {
+            cache = entry;
+        }
+    }
+
+    cache->options = NULL;
+
+    for (i = 0; options[i].name; i++) {
+        if (i == SCPI_CHOICE_CACHE_MAX_OPTIONS) {
+            return NULL;
+        }
+
+        len = strlen(options[i].name);
+        if (len > 255 || (len > 0 && options[i].name[len - 1] == '#')) {
+            /* numeric suffix is matched by matchPattern only */
+            return NULL;
+        }
+        short_len = patternSeparatorShortPos(options[i].name, len);
+
+        cache->long_len[i] = (uint8_t) len;
+        cache->short_len[i] = (uint8_t) short_len;
+        cache->long_hash[i] = hashStr(options[i].name, len);
+        cache->short_hash[i] = hashStr(options[i].name, short_len);
+    }
+
+    cache->options = options;
+    cache->first_name = options[0].name;
+    cache->count = (uint8_t) i;
+    cache->last_used = ++context->choice_cache_counter;
+
+    return cache;
+}
+#endif
+
 /**
  * Convert parameter to choice
  * @param context
@@ -1238,6 +1542,20 @@ scpi_bool_t SCPI_ParamToChoice(scpi_t * context, scpi_parameter_t * parameter, c
     }
 
     if (parameter->type == SCPI_TOKEN_PROGRAM_MNEMONIC) {
+#if SCPI_CHOICE_CACHE_SIZE > 0
+        const scpi_choice_cache_t * cache = getChoiceCache(context, options);
+        if (cache) {
+            uint32_t hash = hashStr(parameter->ptr, parameter->len);
+            for (res = 0; res < cache->count; ++res) {
+                if ((cache->long_hash[res] == hash && compareStr(options[res].name, cache->long_len[res], parameter->ptr, parameter->len)) ||
+                        (cache->short_hash[res] == hash && compareStr(options[res].name, cache->short_len[res], parameter->ptr, parameter->len))) {
+                    *value = options[res].tag;
+                    result = TRUE;
+                    break;
+                }
+            }
+        } else
+#endif
         for (res = 0; options[res].name; ++res) {
             if (matchPattern(options[res].name, strlen(options[res].name), parameter->ptr, parameter->len, NULL)) {
                 *value = options[res].tag;
@@ -1611,13 +1929,38 @@ static size_t produceResultArrayBinary(scpi_t * context, const void * array, siz
     }
 }
 
+static size_t uint32ToStr(uint32_t val, char * str, size_t len) {
+    return SCPI_UInt32ToStrBase(val, str, len, 10);
+}
+
+static size_t uint64ToStr(uint64_t val, char * str, size_t len) {
+    return SCPI_UInt64ToStrBase(val, str, len, 10);
+}
+
+/* delimiter, 64 digits and terminating zero */
+#define RESULT_ARRAY_ITEM_MAX_LENGTH (1 + 64 + 1)
 
-#define RESULT_ARRAY(func) do {\
+/* ASCII items are formatted directly into the output buffer, if there is one */
+#define RESULT_ARRAY(func, toStr) do {\
     size_t result = 0;\
     if (format == SCPI_FORMAT_ASCII) {\
         size_t i;\
+        size_t len;\
+        char * ptr;\
         for (i = 0; i < count; i++) {\
-            result += func(context, array[i]);\
+            ptr = reserveOutputBuffer(context, RESULT_ARRAY_ITEM_MAX_LENGTH);\
+            if (ptr == NULL) {\
+                result += func(context, array[i]);\
+                continue;\
+            }\
+            len = 0;\
+            if (context->output_count > 0) {\
+                ptr[len++] = ',';\
+            }\
+            len += toStr(array[i], ptr + len, RESULT_ARRAY_ITEM_MAX_LENGTH - len);\
+            context->output_buffer.position += len;\
+            context->output_count++;\
+            result += len;\
         }\
     } else {\
         result = produceResultArrayBinary(context, array, count, sizeof(*array), format);\
@@ -1634,7 +1977,7 @@ static size_t produceResultArrayBinary(scpi_t * context, const void * array, siz
  * @return
  */
 size_t SCPI_ResultArrayInt8(scpi_t * context, const int8_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultInt8);
+    RESULT_ARRAY(SCPI_ResultInt8, SCPI_Int32ToStr);
 }
 
 /**
@@ -1646,7 +1989,7 @@ size_t SCPI_ResultArrayInt8(scpi_t * context, const int8_t * array, size_t count
  * @return
  */
 size_t SCPI_ResultArrayUInt8(scpi_t * context, const uint8_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultUInt8);
+    RESULT_ARRAY(SCPI_ResultUInt8, uint32ToStr);
 }
 
 /**
@@ -1658,7 +2001,7 @@ size_t SCPI_ResultArrayUInt8(scpi_t * context, const uint8_t * array, size_t cou
  * @return
  */
 size_t SCPI_ResultArrayInt16(scpi_t * context, const int16_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultInt16);
+    RESULT_ARRAY(SCPI_ResultInt16, SCPI_Int32ToStr);
 }
 
 /**
@@ -1670,7 +2013,7 @@ size_t SCPI_ResultArrayInt16(scpi_t * context, const int16_t * array, size_t cou
  * @return
  */
 size_t SCPI_ResultArrayUInt16(scpi_t * context, const uint16_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultUInt16);
+    RESULT_ARRAY(SCPI_ResultUInt16, uint32ToStr);
 }
 
 /**
@@ -1682,7 +2025,7 @@ size_t SCPI_ResultArrayUInt16(scpi_t * context, const uint16_t * array, size_t c
  * @return
  */
 size_t SCPI_ResultArrayInt32(scpi_t * context, const int32_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultInt32);
+    RESULT_ARRAY(SCPI_ResultInt32, SCPI_Int32ToStr);
 }
 
 /**
@@ -1694,7 +2037,7 @@ size_t SCPI_ResultArrayInt32(scpi_t * context, const int32_t * array, size_t cou
  * @return
  */
 size_t SCPI_ResultArrayUInt32(scpi_t * context, const uint32_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultUInt32);
+    RESULT_ARRAY(SCPI_ResultUInt32, uint32ToStr);
 }
 
 /**
@@ -1706,7 +2049,7 @@ size_t SCPI_ResultArrayUInt32(scpi_t * context, const uint32_t * array, size_t c
  * @return
  */
 size_t SCPI_ResultArrayInt64(scpi_t * context, const int64_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultInt64);
+    RESULT_ARRAY(SCPI_ResultInt64, SCPI_Int64ToStr);
 }
 
 /**
@@ -1718,7 +2061,7 @@ size_t SCPI_ResultArrayInt64(scpi_t * context, const int64_t * array, size_t cou
  * @return
  */
 size_t SCPI_ResultArrayUInt64(scpi_t * context, const uint64_t * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultUInt64);
+    RESULT_ARRAY(SCPI_ResultUInt64, uint64ToStr);
 }
 
 /**
@@ -1730,7 +2073,7 @@ size_t SCPI_ResultArrayUInt64(scpi_t * context, const uint64_t * array, size_t c
  * @return
  */
 size_t SCPI_ResultArrayFloat(scpi_t * context, const float * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultFloat);
+    RESULT_ARRAY(SCPI_ResultFloat, SCPI_FloatToStr);
 }
 
 /**
@@ -1742,7 +2085,7 @@ size_t SCPI_ResultArrayFloat(scpi_t * context, const float * array, size_t count
  * @return
  */
 size_t SCPI_ResultArrayDouble(scpi_t * context, const double * array, size_t count, scpi_array_format_t format) {
-    RESULT_ARRAY(SCPI_ResultDouble);
+    RESULT_ARRAY(SCPI_ResultDouble, SCPI_DoubleToStr);
 }
 
 /*
@@ -290,20 +290,87 @@ const scpi_choice_def_t scpi_special_numbers_def[] = {
     SCPI_CHOICE_LIST_END,
 };
 
+#if SCPI_UNITS_HASH_TABLE_SIZE > 0
+/**
+ * Build hash table of unit names. If the same name (case insensitive) is
+ * defined more then once, the first definition is used like in linear search.
+ * @param context
+ */
+static void buildUnitsHashTable(scpi_t * context) {
+    scpi_units_hash_table_t * table = &context->units_hash_table;
+    const scpi_unit_def_t * units = context->units;
+    size_t i;
+    size_t len;
+    size_t pos;
+    const char * name;
+
+    table->units = units;
+    table->valid = FALSE;
+    memset(table->index, 0, sizeof (table->index));
+
+    if (units == NULL) {
+        return;
+    }
+
+    for (i = 0; units[i].name != NULL; i++) {
+        /* keep load factor under 3/4 */
+        if (4 * (i + 1) > 3 * SCPI_UNITS_HASH_TABLE_SIZE) {
+            return;
+        }
+
+        len = strlen(units[i].name);
+        pos = hashStr(units[i].name, len) % SCPI_UNITS_HASH_TABLE_SIZE;
+        while (table->index[pos] != 0) {
+            name = units[table->index[pos] - 1].name;
+            if (compareStr(name, strlen(name), units[i].name, len)) {
+                break;
+            }
+            pos = (pos + 1) % SCPI_UNITS_HASH_TABLE_SIZE;
+        }
+
+        if (table->index[pos] == 0) {
+            table->index[pos] = (uint16_t) (i + 1);
+        }
+    }
+
+    table->valid = TRUE;
+}
+#endif
+
 /**
  * Convert string describing unit to its representation
- * @param units units patterns
+ * @param context
  * @param unit text representation of unknown unit
  * @param len length of text representation
  * @return pointer of related unit definition or NULL
  */
-static const scpi_unit_def_t * translateUnit(const scpi_unit_def_t * units, const char * unit, size_t len) {
+static const scpi_unit_def_t * translateUnit(scpi_t * context, const char * unit, size_t len) {
+    const scpi_unit_def_t * units = context->units;
     int i;
 
     if (units == NULL) {
         return NULL;
     }
 
+#if SCPI_UNITS_HASH_TABLE_SIZE > 0
+    if (context->units_hash_table.units != units) {
+        buildUnitsHashTable(context);
+    }
+
+    if (context->units_hash_table.valid) {
+        const scpi_unit_def_t * unitDef;
+        size_t pos = hashStr(unit, len) % SCPI_UNITS_HASH_TABLE_SIZE;
+        while (context->units_hash_table.index[pos] != 0) {
+            unitDef = &units[context->units_hash_table.index[pos] - 1];
+            if (compareStr(unit, len, unitDef->name, strlen(unitDef->name))) {
+                return unitDef;
+            }
+            pos = (pos + 1) % SCPI_UNITS_HASH_TABLE_SIZE;
+        }
+        return NULL;
+    }
+#endif
+
     for (i = 0; units[i].name != NULL; i++) {
         if (compareStr(unit, len, units[i].name, strlen(units[i].name))) {
             return &units[i];
@@ -353,7 +420,7 @@ static scpi_bool_t transformNumber(scpi_t * context, const char * unit, size_t l
         return TRUE;
     }
 
-    unitDef = translateUnit(context->units, unit + s, len - s);
+    unitDef = translateUnit(context, unit + s, len - s);
 
     if (unitDef == NULL) {
         SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
@@ -48,7 +48,6 @@
 #include "utils_private.h"
 #include "scpi/utils.h"
 
-static size_t patternSeparatorShortPos(const char * pattern, size_t len);
 static size_t patternSeparatorPos(const char * pattern, size_t len);
 static size_t cmdSeparatorPos(const char * cmd, size_t len);
 
@@ -360,6 +359,25 @@ scpi_bool_t compareStr(const char * str1, size_t len1, const char * str2, size_t
     return FALSE;
 }
 
+/**
+ * Case insensitive hash of the string (FNV-1a), strings equal by compareStr
+ * have equal hash
+ * @param str
+ * @param len
+ * @return
+ */
+uint32_t hashStr(const char * str, size_t len) {
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        hash ^= (uint8_t) toupper((uint8_t) str[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
 /**
  * Compare two strings, one be longer but may contains only numbers in that section
  * @param str1
@@ -427,7 +445,7 @@ size_t skipWhitespace(const char * cmd, size_t len) {
  * @param len - max search length
  * @return position of separator or len
  */
-static size_t patternSeparatorShortPos(const char * pattern, size_t len) {
+size_t patternSeparatorShortPos(const char * pattern, size_t len) {
     size_t i;
     for (i = 0; (i < len) && pattern[i]; i++) {
         if (islower((unsigned char) pattern[i])) {
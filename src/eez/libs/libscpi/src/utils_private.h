@@ -55,6 +55,8 @@ extern "C" {
     char * strnpbrk(const char *str, size_t size, const char *set) LOCAL;
     scpi_bool_t compareStr(const char * str1, size_t len1, const char * str2, size_t len2) LOCAL;
     scpi_bool_t compareStrAndNum(const char * str1, size_t len1, const char * str2, size_t len2, int32_t * num) LOCAL;
+    uint32_t hashStr(const char * str, size_t len) LOCAL;
+    size_t patternSeparatorShortPos(const char * pattern, size_t len) LOCAL;
     size_t UInt32ToStrBaseSign(uint32_t val, char * str, size_t len, int8_t base, scpi_bool_t sign) LOCAL;
     size_t UInt64ToStrBaseSign(uint64_t val, char * str, size_t len, int8_t base, scpi_bool_t sign) LOCAL;
     size_t strBaseToInt32(const char * str, int32_t * val, int8_t base) LOCAL;
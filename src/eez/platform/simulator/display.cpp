@@ -16,10 +16,11 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <string>
 
-#if !defined(__EMSCRIPTEN__)
+#if EEZ_SIMULATOR_SDL
 #include <SDL.h>
 #include <SDL_image.h>
 #endif
@@ -39,15 +40,23 @@
 
 #include <eez/gui/display-private.h>
 
+#include <eez/platform/simulator/events.h>
+
 namespace eez {
 namespace gui {
 namespace display {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-#if !defined(__EMSCRIPTEN__)
+#if EEZ_SIMULATOR_SDL
 static SDL_Window *g_mainWindow;
 static SDL_Renderer *g_renderer;
+
+// persistent streaming texture, only changed part of the frame is uploaded
+static SDL_Texture *g_texture;
+// copy of the frame that is currently in the texture
+static uint32_t *g_presentedBuffer;
+static uint32_t g_lastPresentTime;
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -67,7 +76,7 @@ std::string getFullPath(std::string category, std::string path) {
 }
 
 void initDriver() {
-#if !defined(__EMSCRIPTEN__)
+#if EEZ_SIMULATOR_SDL
     // Set texture filtering to linear
     if (!SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "1")) {
         printf("Warning: Linear texture filtering not enabled!");
@@ -91,12 +100,27 @@ void initDriver() {
 
     SDL_SetRenderDrawBlendMode(g_renderer, SDL_BLENDMODE_BLEND);
 
+    g_texture = SDL_CreateTexture(g_renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    if (g_texture == NULL) {
+        printf("Unable to create texture! SDL Error: %s\n", SDL_GetError());
+    } else {
+        SDL_SetTextureBlendMode(g_texture, SDL_BLENDMODE_BLEND);
+    }
+
+    g_presentedBuffer = (uint32_t *)calloc(DISPLAY_WIDTH * DISPLAY_HEIGHT, sizeof(uint32_t));
+
+    // content of a new streaming texture is undefined, make it match g_presentedBuffer
+    // so syncBuffer can skip the pixels that are the same in both
+    if (g_texture && g_presentedBuffer) {
+        SDL_UpdateTexture(g_texture, NULL, g_presentedBuffer, DISPLAY_WIDTH * sizeof(uint32_t));
+    }
+
     // Initialize PNG loading
     int imgFlags = IMG_INIT_PNG;
     if ((IMG_Init(imgFlags) & imgFlags) != imgFlags) {
         printf("SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError());
     } else {
-#if !defined(__EMSCRIPTEN__)
+#if EEZ_SIMULATOR_SDL
         // Set icon
         SDL_Surface *iconSurface = IMG_Load(getFullPath("images", ICON).c_str());
         if (!iconSurface) {
@@ -119,32 +143,90 @@ void initDriver() {
 #endif
 }
 
+#if EEZ_SIMULATOR_SDL
+// Finds the bounding rectangle of the pixels that differ between the buffer
+// and the last presented frame. Returns false if there is no difference.
+static bool getChangedRect(const uint32_t *buffer, SDL_Rect &rect) {
+    const size_t lineSize = DISPLAY_WIDTH * sizeof(uint32_t);
+
+    int y1 = 0;
+    while (y1 < (int)DISPLAY_HEIGHT && memcmp(buffer + y1 * DISPLAY_WIDTH, g_presentedBuffer + y1 * DISPLAY_WIDTH, lineSize) == 0) {
+        y1++;
+    }
+    if (y1 == (int)DISPLAY_HEIGHT) {
+        return false;
+    }
+
+    int y2 = DISPLAY_HEIGHT - 1;
+    while (y2 > y1 && memcmp(buffer + y2 * DISPLAY_WIDTH, g_presentedBuffer + y2 * DISPLAY_WIDTH, lineSize) == 0) {
+        y2--;
+    }
+
+    int x1 = DISPLAY_WIDTH - 1;
+    int x2 = 0;
+    for (int y = y1; y <= y2; y++) {
+        const uint32_t *src = buffer + y * DISPLAY_WIDTH;
+        const uint32_t *dst = g_presentedBuffer + y * DISPLAY_WIDTH;
+
+        int x = 0;
+        while (x < x1 && src[x] == dst[x]) {
+            x++;
+        }
+        x1 = x;
+
+        x = DISPLAY_WIDTH - 1;
+        while (x > x2 && src[x] == dst[x]) {
+            x--;
+        }
+        x2 = x;
+    }
+
+    rect.x = x1;
+    rect.y = y1;
+    rect.w = x2 - x1 + 1;
+    rect.h = y2 - y1 + 1;
+
+    return rect.w > 0;
+}
+#endif
+
 void syncBuffer() {
-#if !defined(__EMSCRIPTEN__)
-    if (!g_mainWindow) {
+#if EEZ_SIMULATOR_SDL
+    if (!g_mainWindow || !g_texture || !g_presentedBuffer) {
 		return;
     }
 
-    SDL_Surface *rgbSurface = SDL_CreateRGBSurfaceFrom(
-        (uint32_t *)g_syncedBuffer, DISPLAY_WIDTH, DISPLAY_HEIGHT, 32, 4 * DISPLAY_WIDTH, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
-    if (rgbSurface != NULL) {
-        SDL_Texture *texture = SDL_CreateTextureFromSurface(g_renderer, rgbSurface);
-        if (texture != NULL) {
-            SDL_Rect srcRect = { 0, 0, (int)DISPLAY_WIDTH, (int)DISPLAY_HEIGHT };
-            SDL_Rect dstRect = { 0, 0, (int)DISPLAY_WIDTH, (int)DISPLAY_HEIGHT };
+    const uint32_t *buffer = (uint32_t *)g_syncedBuffer;
 
-            SDL_RenderCopyEx(g_renderer, texture, &srcRect, &dstRect, 0.0, NULL, SDL_FLIP_NONE);
+    SDL_Rect rect;
+    if (getChangedRect(buffer, rect)) {
+        SDL_UpdateTexture(g_texture, &rect, buffer + rect.y * DISPLAY_WIDTH + rect.x, DISPLAY_WIDTH * sizeof(uint32_t));
 
-            SDL_DestroyTexture(texture);
-        } else {
-            printf("Unable to create texture from image buffer! SDL Error: %s\n", SDL_GetError());
+        for (int y = rect.y; y < rect.y + rect.h; y++) {
+            memcpy(g_presentedBuffer + y * DISPLAY_WIDTH + rect.x, buffer + y * DISPLAY_WIDTH + rect.x, rect.w * sizeof(uint32_t));
         }
-        SDL_FreeSurface(rgbSurface);
+
+        platform::simulator::g_windowExposed = true;
+    }
+
+    if (platform::simulator::g_windowExposed) {
+        platform::simulator::g_windowExposed = false;
+
+        SDL_RenderCopy(g_renderer, g_texture, NULL, NULL);
+        SDL_RenderPresent(g_renderer);
     } else {
-        printf("Unable to render text surface! SDL Error: %s\n", SDL_GetError());
+        // nothing changed, keep the frame rate that vsync would give
+        auto elapsed = millis() - g_lastPresentTime;
+        if (elapsed < 16) {
+            osDelay(16 - elapsed);
+        }
     }
-    SDL_RenderPresent(g_renderer);
 
+    g_lastPresentTime = millis();
+
+    sendMessageToGuiThread(GUI_QUEUE_MESSAGE_TYPE_DISPLAY_VSYNC, 0, 0);
+#elif EEZ_OPTION_HEADLESS_DISPLAY
+    // nothing to present, render the next frame right away
     sendMessageToGuiThread(GUI_QUEUE_MESSAGE_TYPE_DISPLAY_VSYNC, 0, 0);
 #endif
 
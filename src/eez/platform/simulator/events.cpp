@@ -16,7 +16,7 @@
 
 #include <math.h>
 
-#if !defined(__EMSCRIPTEN__)
+#if EEZ_SIMULATOR_SDL
 #include <SDL.h>
 #endif
 
@@ -36,9 +36,10 @@ namespace simulator {
 int g_mouseX;
 int g_mouseY;
 bool g_mouseButton1IsPressed;
+bool g_windowExposed;
 
 void readEvents() {
-#if !defined(__EMSCRIPTEN__)
+#if EEZ_SIMULATOR_SDL
     int yMouseWheel = 0;
     bool mouseButton2IsUp = false;
 
@@ -64,6 +65,9 @@ void readEvents() {
         } else if (event.type == SDL_WINDOWEVENT)  {
             if (event.window.event == SDL_WINDOWEVENT_SHOWN || event.window.event == SDL_WINDOWEVENT_RESTORED) {
                 eez::gui::refreshScreen();
+                g_windowExposed = true;
+            } else if (event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+                g_windowExposed = true;
             }
         }
 
@@ -86,7 +90,7 @@ void readEvents() {
 }
 
 bool isMiddleButtonPressed() {
-#if !defined(__EMSCRIPTEN__)
+#if EEZ_SIMULATOR_SDL
     int x;
     int y;
 	osDelay(1000);
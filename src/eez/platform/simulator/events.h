@@ -18,6 +18,9 @@ extern int g_mouseX;
 extern int g_mouseY;
 extern bool g_mouseButton1IsPressed;
 
+// window content was lost (shown, restored, exposed) and must be presented again
+extern bool g_windowExposed;
+
 void readEvents();
 
 bool isMiddleButtonPressed();
@@ -0,0 +1,164 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Round trip of the chunked assets format (HEADER_TAG_CHUNKED): assets are
+// encoded here the same way as the assets builder lays them out and decoded
+// with initAssetsChunks/getAssetsChunk. Built with a small
+// EEZ_ASSETS_CHUNKS_CACHE_SIZE, so cache eviction is covered too.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include <eez/core/alloc.h>
+#include <eez/core/assets_chunks.h>
+#include <eez/libs/lz4/lz4.h>
+
+namespace eez {
+
+void *alloc(size_t size, uint32_t id) {
+    return ::malloc(size);
+}
+
+void free(void *ptr) {
+    ::free(ptr);
+}
+
+} // namespace eez
+
+using namespace eez;
+
+static std::vector<uint8_t> compress(const std::vector<uint8_t> &data) {
+    std::vector<uint8_t> compressed(LZ4_compressBound((int)data.size()));
+    int compressedSize = LZ4_compress_default((const char *)data.data(), (char *)compressed.data(), (int)data.size(), (int)compressed.size());
+    compressed.resize(compressedSize);
+    return compressed;
+}
+
+static void append(std::vector<uint8_t> &assets, const void *data, size_t size) {
+    assets.insert(assets.end(), (const uint8_t *)data, (const uint8_t *)data + size);
+}
+
+// ChunkedHeader, compressed main part, chunks table and compressed chunks
+static std::vector<uint8_t> encodeChunkedAssets(const std::vector<uint8_t> &mainPart, const std::vector<std::vector<uint8_t>> &chunks) {
+    auto compressedMainPart = compress(mainPart);
+
+    ChunkedHeader header;
+    memset(&header, 0, sizeof(header));
+    header.tag = HEADER_TAG_CHUNKED;
+    header.projectMajorVersion = PROJECT_VERSION_V3;
+    header.decompressedSize = (uint32_t)mainPart.size();
+    header.compressedSize = (uint32_t)compressedMainPart.size();
+    header.numChunks = (uint32_t)chunks.size();
+
+    std::vector<uint8_t> assets;
+    append(assets, &header, sizeof(header));
+    append(assets, compressedMainPart.data(), compressedMainPart.size());
+
+    auto chunksTableOffset = assets.size();
+    assets.resize(assets.size() + chunks.size() * sizeof(AssetsChunk));
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        auto compressedChunk = compress(chunks[i]);
+
+        AssetsChunk chunk;
+        chunk.offset = (uint32_t)assets.size();
+        chunk.compressedSize = (uint32_t)compressedChunk.size();
+        chunk.decompressedSize = (uint32_t)chunks[i].size();
+        memcpy(assets.data() + chunksTableOffset + i * sizeof(AssetsChunk), &chunk, sizeof(AssetsChunk));
+
+        append(assets, compressedChunk.data(), compressedChunk.size());
+    }
+
+    return assets;
+}
+
+static std::vector<uint8_t> makeData(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        // compressible, but different for every seed
+        data[i] = (uint8_t)((i / 7) * seed + (seed >> 3));
+    }
+    return data;
+}
+
+static int g_numFailed;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        printf("FAIL %s\n", what);
+        g_numFailed++;
+    }
+}
+
+int main() {
+    auto mainPart = makeData(1000, 1);
+
+    std::vector<std::vector<uint8_t>> chunks;
+    for (uint32_t i = 0; i < 8; i++) {
+        chunks.push_back(makeData(100 + 10 * i, 17 + i));
+    }
+
+    auto assets = encodeChunkedAssets(mainPart, chunks);
+
+    // main part
+    auto header = (const ChunkedHeader *)assets.data();
+    std::vector<uint8_t> decompressedMainPart(header->decompressedSize);
+    int result = LZ4_decompress_safe(
+        (const char *)assets.data() + sizeof(ChunkedHeader),
+        (char *)decompressedMainPart.data(),
+        header->compressedSize,
+        header->decompressedSize
+    );
+    check(result == (int)mainPart.size() && decompressedMainPart == mainPart, "main part round trip");
+
+    initAssetsChunks(assets.data(), (uint32_t)assets.size());
+
+    // every chunk, twice, with the prefix copied in front of the data
+    const char prefix[] = "prefix";
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t i = 0; i < chunks.size(); i++) {
+            auto data = getAssetsChunk(i, prefix, sizeof(prefix));
+            check(data != nullptr, "chunk loaded");
+            if (data) {
+                check(memcmp(data, prefix, sizeof(prefix)) == 0, "chunk prefix");
+                check(memcmp(data + sizeof(prefix), chunks[i].data(), chunks[i].size()) == 0, "chunk round trip");
+            }
+        }
+    }
+
+    AssetsChunksCacheStats stats;
+    getAssetsChunksCacheStats(stats);
+    check(stats.cacheSize <= EEZ_ASSETS_CHUNKS_CACHE_SIZE, "cache size is bounded");
+    check(stats.evictions > 0, "chunks are evicted");
+    check(stats.hits + stats.misses == 2 * chunks.size(), "hits and misses are counted");
+
+    // most recently used chunk is a hit
+    getAssetsChunk(3, prefix, sizeof(prefix));
+    getAssetsChunksCacheStats(stats);
+    auto hits = stats.hits;
+    getAssetsChunk(3, prefix, sizeof(prefix));
+    getAssetsChunksCacheStats(stats);
+    check(stats.hits == hits + 1, "most recently used chunk is kept");
+
+    check(getAssetsChunk((uint32_t)chunks.size(), prefix, sizeof(prefix)) == nullptr, "invalid chunk index");
+
+    // chunks table beyond the assets data is rejected
+    initAssetsChunks(assets.data(), sizeof(ChunkedHeader) + header->compressedSize);
+    check(getAssetsChunk(0, prefix, sizeof(prefix)) == nullptr, "truncated chunks table");
+
+    if (g_numFailed == 0) {
+        printf("OK\n");
+    }
+
+    return g_numFailed > 0 ? 1 : 0;
+}
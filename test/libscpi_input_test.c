@@ -0,0 +1,113 @@
+/*
+ * eez-framework
+ *
+ * MIT License
+ * Copyright 2024 Envox d.o.o.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// SCPI_Input framing regression tests, input is fed in one piece and byte by
+// byte, which must give the same result.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <scpi/scpi.h>
+
+static int g_numErrors;
+static char g_text[64];
+static size_t g_textLength;
+static int g_numTextCommands;
+
+static int onError(scpi_t *context, int_fast16_t err) {
+    (void)context;
+    (void)err;
+    g_numErrors++;
+    return 0;
+}
+
+static size_t onWrite(scpi_t *context, const char *data, size_t len) {
+    (void)context;
+    (void)data;
+    return len;
+}
+
+static scpi_result_t text(scpi_t *context) {
+    if (!SCPI_ParamCopyText(context, g_text, sizeof(g_text), &g_textLength, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+    g_numTextCommands++;
+    return SCPI_RES_OK;
+}
+
+static const scpi_command_t g_commands[] = {
+    { "TEST:TEXT", text, 0 },
+    SCPI_CMD_LIST_END
+};
+
+static scpi_interface_t g_interface = { onError, onWrite, NULL, NULL, NULL, NULL, NULL };
+
+static char g_inputBuffer[256];
+static scpi_error_t g_errorQueue[16];
+
+static void input(const char *data, size_t len, int byteByByte) {
+    scpi_t context;
+    size_t i;
+
+    memset(&context, 0, sizeof(context));
+    SCPI_Init(&context, g_commands, &g_interface, scpi_units_def, "EEZ", "TEST", "0", "0",
+        g_inputBuffer, sizeof(g_inputBuffer), g_errorQueue, sizeof(g_errorQueue) / sizeof(g_errorQueue[0]));
+
+    g_numErrors = 0;
+    g_numTextCommands = 0;
+    g_textLength = 0;
+
+    if (byteByByte) {
+        for (i = 0; i < len; i++) {
+            SCPI_Input(&context, data + i, 1);
+        }
+    } else {
+        SCPI_Input(&context, data, (int)len);
+    }
+}
+
+static int expectText(const char *name, const char *data, const char *expectedText, int expectedCommands) {
+    int failed = 0;
+    int byteByByte;
+
+    for (byteByByte = 0; byteByByte < 2; byteByByte++) {
+        input(data, strlen(data), byteByByte);
+
+        if (g_numErrors != 0 || g_numTextCommands != expectedCommands ||
+            g_textLength != strlen(expectedText) || memcmp(g_text, expectedText, g_textLength) != 0
+        ) {
+            printf("FAIL %s%s: %d errors, %d commands, text \"%.*s\"\n",
+                name, byteByByte ? " (byte by byte)" : "",
+                g_numErrors, g_numTextCommands, (int)g_textLength, g_text);
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
+
+int main() {
+    int failed = 0;
+
+    failed |= expectText("plain string", "TEST:TEXT \"abc\"\n", "abc", 1);
+
+    // <CR> and <LF> inside quotes are string content, not message termination
+    failed |= expectText("newline in double quotes", "TEST:TEXT \"a\nb;\"\"c\"\n", "a\nb;\"c", 1);
+    failed |= expectText("crlf in single quotes", "TEST:TEXT 'a\r\nb'\r\n", "a\r\nb", 1);
+
+    // message after a string with a newline is parsed on its own
+    failed |= expectText("message after newline in quotes", "TEST:TEXT \"x\ny\"\nTEST:TEXT \"z\"\n", "z", 2);
+
+    if (!failed) {
+        printf("OK\n");
+    }
+
+    return failed;
+}